@@ -0,0 +1,423 @@
+//  ------------------------------------
+//      Copyright (C) 2018 MO ELomari
+//  ------------------------------------
+
+// The atomic compressed pair class updates both members of a compressed_pair
+// atomically, e.g. a ( pointer, version counter ) pair to avoid ABA in lock-free
+// stacks and queues. The storage depends on the size of the pair:
+//
+//   - up to 8 bytes: a std::atomic of an unsigned integer of the same size,
+//   - up to 16 bytes: a double-width compare-and-swap ( cmpxchg16b on x86-64,
+//     requires -mcx16 or an -march which implies it ),
+//   - otherwise: the pair guarded by a spin lock.
+//
+// like std::atomic, values are compared bitwise ( padding bits excluded ).
+//
+// the storage of the pairs of 9 to 16 bytes, and so the layout of
+// atomic_compressed_pair, depends on -mcx16: all the translation units sharing
+// an atomic_compressed_pair must be compiled with the same flags. the class is
+// declared in an inline namespace named after the configuration, so that a
+// mixed build fails to link the functions taking it instead of merging the
+// inline member functions of both layouts.
+
+#ifndef __ATOMIC_COMPRESSED_PAIR_HXX__
+#define __ATOMIC_COMPRESSED_PAIR_HXX__
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "compressed_pair.hxx"
+
+#if defined(__x86_64__) && defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16)
+#define ATOMIC_COMPRESSED_PAIR_DWCAS 1
+#define ATOMIC_COMPRESSED_PAIR_ABI atomic_compressed_pair_dwcas
+#else
+#define ATOMIC_COMPRESSED_PAIR_ABI atomic_compressed_pair_locked
+#endif
+
+
+namespace detail {
+
+// copies the value representation of value into word, the padding bits and
+// the bytes past sizeof(T) are zeroed so that equal values compare equal
+template <typename Word, typename T>
+auto to_atomic_word(const T& value) noexcept -> Word
+{
+    static_assert(sizeof(T) <= sizeof(Word));
+
+    T copy = value;
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_clear_padding)
+    __builtin_clear_padding(&copy);
+#endif
+#endif
+
+    Word word{};
+    std::memcpy(&word, &copy, sizeof(T));
+    return word;
+}
+
+template <typename T, typename Word>
+auto from_atomic_word(const Word& word) noexcept -> T
+{
+    unsigned char bytes[sizeof(T)];
+    std::memcpy(bytes, &word, sizeof(T));
+    return std::bit_cast<T>(bytes);
+}
+
+
+template <std::size_t Size>
+using atomic_word_t = std::conditional_t<Size <= 1, std::uint8_t,
+                      std::conditional_t<Size <= 2, std::uint16_t,
+                      std::conditional_t<Size <= 4, std::uint32_t, std::uint64_t>>>;
+
+
+enum class atomic_storage_kind
+{
+    word,
+    double_word,
+    locked
+};
+
+template <typename T>
+inline constexpr atomic_storage_kind atomic_storage_kind_of =
+    sizeof(T) <= sizeof(std::uint64_t) ? atomic_storage_kind::word :
+#if defined(ATOMIC_COMPRESSED_PAIR_DWCAS)
+    sizeof(T) <= 2 * sizeof(std::uint64_t) ? atomic_storage_kind::double_word :
+#endif
+    atomic_storage_kind::locked;
+
+
+template <typename T, atomic_storage_kind = atomic_storage_kind_of<T>>
+class atomic_storage;
+
+// #1 the value fits in a native atomic integer
+template <typename T>
+class atomic_storage<T, atomic_storage_kind::word>
+{
+    using word_type = atomic_word_t<sizeof(T)>;
+
+public:
+    static constexpr bool is_always_lock_free = std::atomic<word_type>::is_always_lock_free;
+
+
+public:
+    explicit atomic_storage(const T& value) noexcept
+        : m_word(to_atomic_word<word_type>(value))
+    {
+    }
+
+
+public:
+    auto load(std::memory_order order) const noexcept -> T
+    {
+        return from_atomic_word<T>(this->m_word.load(order));
+    }
+
+    void store(const T& desired, std::memory_order order) noexcept
+    {
+        this->m_word.store(to_atomic_word<word_type>(desired), order);
+    }
+
+    auto exchange(const T& desired, std::memory_order order) noexcept -> T
+    {
+        return from_atomic_word<T>(this->m_word.exchange(to_atomic_word<word_type>(desired), order));
+    }
+
+    auto compare_exchange_weak(T& expected, const T& desired, std::memory_order success,
+                               std::memory_order failure) noexcept -> bool
+    {
+        auto word = to_atomic_word<word_type>(expected);
+        const bool exchanged = this->m_word.compare_exchange_weak(
+            word, to_atomic_word<word_type>(desired), success, failure);
+
+        if (not exchanged) expected = from_atomic_word<T>(word);
+        return exchanged;
+    }
+
+    auto compare_exchange_strong(T& expected, const T& desired, std::memory_order success,
+                                 std::memory_order failure) noexcept -> bool
+    {
+        auto word = to_atomic_word<word_type>(expected);
+        const bool exchanged = this->m_word.compare_exchange_strong(
+            word, to_atomic_word<word_type>(desired), success, failure);
+
+        if (not exchanged) expected = from_atomic_word<T>(word);
+        return exchanged;
+    }
+
+private:
+    std::atomic<word_type> m_word;
+};
+
+
+#if defined(ATOMIC_COMPRESSED_PAIR_DWCAS)
+
+// #2 the value fits in two words, every operation is a ( sequentially
+// consistent ) cmpxchg16b
+template <typename T>
+class atomic_storage<T, atomic_storage_kind::double_word>
+{
+    __extension__ using word_type = unsigned __int128;
+
+public:
+    static constexpr bool is_always_lock_free = true;
+
+
+public:
+    explicit atomic_storage(const T& value) noexcept
+        : m_word(to_atomic_word<word_type>(value))
+    {
+    }
+
+
+public:
+    auto load(std::memory_order) const noexcept -> T
+    {
+        return from_atomic_word<T>(this->load_word());
+    }
+
+    void store(const T& desired, std::memory_order order) noexcept
+    {
+        this->exchange(desired, order);
+    }
+
+    auto exchange(const T& desired, std::memory_order) noexcept -> T
+    {
+        const auto new_word = to_atomic_word<word_type>(desired);
+        auto old_word = this->load_word();
+
+        for (;;)
+        {
+            const auto previous = __sync_val_compare_and_swap(&this->m_word, old_word, new_word);
+            if (previous == old_word) return from_atomic_word<T>(previous);
+
+            old_word = previous;
+        }
+    }
+
+    auto compare_exchange_weak(T& expected, const T& desired, std::memory_order success,
+                               std::memory_order failure) noexcept -> bool
+    {
+        return this->compare_exchange_strong(expected, desired, success, failure);
+    }
+
+    auto compare_exchange_strong(T& expected, const T& desired, std::memory_order,
+                                 std::memory_order) noexcept -> bool
+    {
+        const auto old_word = to_atomic_word<word_type>(expected);
+        const auto previous = __sync_val_compare_and_swap(
+            &this->m_word, old_word, to_atomic_word<word_type>(desired));
+
+        if (previous == old_word) return true;
+
+        expected = from_atomic_word<T>(previous);
+        return false;
+    }
+
+private:
+    // a plain 16 bytes read isn't atomic, exchanging 0 for 0 reads the value
+    // without changing it
+    auto load_word() const noexcept -> word_type
+    {
+        return __sync_val_compare_and_swap(&this->m_word, word_type(0), word_type(0));
+    }
+
+private:
+    alignas(16) mutable word_type m_word;
+};
+
+#endif
+
+
+// #3 fallback, the value is guarded by a spin lock
+template <typename T>
+class atomic_storage<T, atomic_storage_kind::locked>
+{
+
+public:
+    static constexpr bool is_always_lock_free = false;
+
+
+public:
+    explicit atomic_storage(const T& value) noexcept : m_value(value) {}
+
+
+public:
+    auto load(std::memory_order) const noexcept -> T
+    {
+        const lock_guard guard(this->m_lock);
+        return this->m_value;
+    }
+
+    void store(const T& desired, std::memory_order) noexcept
+    {
+        const lock_guard guard(this->m_lock);
+        this->m_value = desired;
+    }
+
+    auto exchange(const T& desired, std::memory_order) noexcept -> T
+    {
+        const lock_guard guard(this->m_lock);
+        return std::exchange(this->m_value, desired);
+    }
+
+    auto compare_exchange_weak(T& expected, const T& desired, std::memory_order success,
+                               std::memory_order failure) noexcept -> bool
+    {
+        return this->compare_exchange_strong(expected, desired, success, failure);
+    }
+
+    auto compare_exchange_strong(T& expected, const T& desired, std::memory_order,
+                                 std::memory_order) noexcept -> bool
+    {
+        const lock_guard guard(this->m_lock);
+
+        const auto current = to_atomic_word<word_bytes>(this->m_value);
+        const auto wanted  = to_atomic_word<word_bytes>(expected);
+
+        if (std::memcmp(current.bytes, wanted.bytes, sizeof(T)) == 0)
+        {
+            this->m_value = desired;
+            return true;
+        }
+
+        expected = this->m_value;
+        return false;
+    }
+
+private:
+    struct word_bytes { unsigned char bytes[sizeof(T)]; };
+
+    class lock_guard
+    {
+    public:
+        explicit lock_guard(std::atomic_flag& lock) noexcept : m_lock(lock)
+        {
+            while (this->m_lock.test_and_set(std::memory_order_acquire)) std::this_thread::yield();
+        }
+
+        ~lock_guard() { this->m_lock.clear(std::memory_order_release); }
+
+        lock_guard(const lock_guard&) = delete;
+        auto operator=(const lock_guard&) -> lock_guard& = delete;
+
+    private:
+        std::atomic_flag& m_lock;
+    };
+
+    mutable std::atomic_flag m_lock;
+    T m_value;
+};
+
+}  // namespace detail
+
+/** END **/
+
+
+
+// MAIN CLASS
+inline namespace ATOMIC_COMPRESSED_PAIR_ABI {
+
+template <typename T1, typename T2>
+class atomic_compressed_pair
+{
+
+public:
+    using value_type = compressed_pair<T1, T2>;
+
+    static_assert(std::is_trivially_copyable<value_type>::value,
+                  "atomic_compressed_pair requires a trivially copyable compressed_pair");
+
+    static constexpr bool is_always_lock_free = detail::atomic_storage<value_type>::is_always_lock_free;
+
+
+public:
+    // Default constructor. Value-initializes both elements of the pair
+    atomic_compressed_pair() noexcept(std::is_nothrow_default_constructible<value_type>::value)
+        requires(std::is_default_constructible<value_type>::value)
+        : m_storage(value_type())
+    {
+    }
+
+    atomic_compressed_pair(const value_type& desired) noexcept : m_storage(desired) {}
+
+    atomic_compressed_pair(const atomic_compressed_pair&) = delete;
+    auto operator=(const atomic_compressed_pair&) -> atomic_compressed_pair& = delete;
+
+
+public:
+    auto is_lock_free() const noexcept -> bool { return is_always_lock_free; }
+
+    auto load(std::memory_order order = std::memory_order_seq_cst) const noexcept -> value_type
+    {
+        return this->m_storage.load(order);
+    }
+
+    void store(const value_type& desired, std::memory_order order = std::memory_order_seq_cst) noexcept
+    {
+        this->m_storage.store(desired, order);
+    }
+
+    auto exchange(const value_type& desired, std::memory_order order = std::memory_order_seq_cst) noexcept
+        -> value_type
+    {
+        return this->m_storage.exchange(desired, order);
+    }
+
+    auto compare_exchange_weak(value_type& expected, const value_type& desired,
+                               std::memory_order success, std::memory_order failure) noexcept -> bool
+    {
+        return this->m_storage.compare_exchange_weak(expected, desired, success, failure);
+    }
+
+    auto compare_exchange_weak(value_type& expected, const value_type& desired,
+                               std::memory_order order = std::memory_order_seq_cst) noexcept -> bool
+    {
+        return this->m_storage.compare_exchange_weak(expected, desired, order, failure_order(order));
+    }
+
+    auto compare_exchange_strong(value_type& expected, const value_type& desired,
+                                 std::memory_order success, std::memory_order failure) noexcept -> bool
+    {
+        return this->m_storage.compare_exchange_strong(expected, desired, success, failure);
+    }
+
+    auto compare_exchange_strong(value_type& expected, const value_type& desired,
+                                 std::memory_order order = std::memory_order_seq_cst) noexcept -> bool
+    {
+        return this->m_storage.compare_exchange_strong(expected, desired, order, failure_order(order));
+    }
+
+
+public:
+    operator value_type() const noexcept { return this->load(); }
+
+    auto operator=(const value_type& desired) noexcept -> value_type
+    {
+        this->store(desired);
+        return desired;
+    }
+
+
+private:
+    // the failure order can't be a release order
+    static constexpr auto failure_order(std::memory_order order) noexcept -> std::memory_order
+    {
+        if (order == std::memory_order_acq_rel) return std::memory_order_acquire;
+        if (order == std::memory_order_release) return std::memory_order_relaxed;
+        return order;
+    }
+
+private:
+    detail::atomic_storage<value_type> m_storage;
+};
+
+}  // inline namespace ATOMIC_COMPRESSED_PAIR_ABI
+#endif
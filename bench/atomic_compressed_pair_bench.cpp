@@ -0,0 +1,125 @@
+//  ------------------------------------
+//      Copyright (C) 2018 MO ELomari
+//  ------------------------------------
+
+// push/pop throughput of a Treiber stack from 1 thread to one per hardware
+// thread ( at least 8, where the contention shows on small machines ). the ( top,
+// version ) head is an atomic_compressed_pair<node*, u64>: a cmpxchg16b when
+// the benchmarks are built with -mcx16 ( the default on x86-64, see
+// CMakeLists.txt ), a spin lock otherwise. the baseline is the same stack
+// guarded by a std::mutex. the is_always_lock_free counter tells which storage
+// was measured.
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "atomic_compressed_pair.hxx"
+
+
+namespace {
+
+const int max_threads = std::max(8, static_cast<int>(std::thread::hardware_concurrency()));
+
+// the next pointer of a node popped by a thread may still be read by another
+// one whose compare-exchange is about to fail, it is atomic ( relaxed: the
+// head is the synchronization point )
+struct node
+{
+    std::atomic<node*> next = nullptr;
+};
+
+class treiber_stack
+{
+    using head_t = compressed_pair<node*, std::uint64_t>;
+
+public:
+    static constexpr bool is_lock_free = atomic_compressed_pair<node*, std::uint64_t>::is_always_lock_free;
+
+    void push(node* n) noexcept
+    {
+        auto old = this->m_head.load(std::memory_order_relaxed);
+        do { n->next.store(old.first(), std::memory_order_relaxed); }
+        while (not this->m_head.compare_exchange_weak(old, head_t(n, old.second() + 1),
+                                                      std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    // the nodes are never freed while the stack is used, reading the next
+    // pointer of a node popped by another thread is safe, the version counter
+    // detects that the top has changed in between
+    auto pop() noexcept -> node*
+    {
+        auto old = this->m_head.load(std::memory_order_acquire);
+        while (old.first() != nullptr and
+               not this->m_head.compare_exchange_weak(old, head_t(old.first()->next.load(std::memory_order_relaxed),
+                                                                  old.second() + 1),
+                                                      std::memory_order_acquire, std::memory_order_acquire))
+        {
+        }
+        return old.first();
+    }
+
+private:
+    atomic_compressed_pair<node*, std::uint64_t> m_head;
+};
+
+class locked_stack
+{
+
+public:
+    static constexpr bool is_lock_free = false;
+
+    void push(node* n)
+    {
+        const std::lock_guard guard(this->m_mutex);
+        n->next.store(this->m_top, std::memory_order_relaxed);
+        this->m_top = n;
+    }
+
+    auto pop() -> node*
+    {
+        const std::lock_guard guard(this->m_mutex);
+        auto top = this->m_top;
+        if (top != nullptr) this->m_top = top->next.load(std::memory_order_relaxed);
+        return top;
+    }
+
+private:
+    std::mutex m_mutex;
+    node* m_top = nullptr;
+};
+
+
+// every thread pushes a node and pops one, which is never null: each thread
+// pops at most as many nodes as it has pushed. the stack and the nodes are
+// shared by the threads of a run.
+template <typename Stack>
+void push_pop(benchmark::State& state)
+{
+    static Stack stack;
+    static std::vector<node> nodes(static_cast<std::size_t>(max_threads));
+
+    node* held = &nodes[static_cast<std::size_t>(state.thread_index())];
+
+    for (auto _ : state)
+    {
+        stack.push(held);
+        held = stack.pop();
+        benchmark::DoNotOptimize(held);
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * 2));
+    state.counters["is_always_lock_free"] = benchmark::Counter(Stack::is_lock_free, benchmark::Counter::kAvgThreads);
+}
+
+}  // namespace
+
+
+BENCHMARK_TEMPLATE(push_pop, treiber_stack)->ThreadRange(1, max_threads)->UseRealTime();
+BENCHMARK_TEMPLATE(push_pop, locked_stack)->ThreadRange(1, max_threads)->UseRealTime();
@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+#  ------------------------------------
+#      Copyright (C) 2018 MO ELomari
+#  ------------------------------------
+
+"""Compares two Google Benchmark json outputs ( e.g. before and after a change ).
+
+A benchmark is flagged when
+  - its time ( or its rss / max_rss counter ) grows by more than --threshold,
+  - its sizeof or alignof counter grows at all,
+  - it is missing from the contender ( deleted or renamed ), unless --allow-missing.
+The exit status is 1 when any benchmark is flagged.
+"""
+
+import argparse
+import json
+import sys
+
+TIME_UNITS = {"ns": 1e-9, "us": 1e-6, "ms": 1e-3, "s": 1.0}
+
+# counters compared with the threshold, and counters which must never grow
+MEMORY_COUNTERS = ("rss", "max_rss")
+LAYOUT_COUNTERS = ("sizeof", "alignof")
+
+
+def load(path, statistic):
+    with open(path) as file:
+        benchmarks = json.load(file)["benchmarks"]
+
+    # with --benchmark_repetitions only the chosen aggregate is kept
+    aggregates = {b["run_name"]: b for b in benchmarks
+                  if b.get("run_type") == "aggregate" and b.get("aggregate_name") == statistic}
+
+    result = {}
+    for b in benchmarks:
+        if b.get("run_type") == "aggregate": continue
+        name = b.get("run_name", b["name"])
+        result[name] = aggregates.get(name, b)
+    return result
+
+
+def seconds(benchmark, key):
+    return benchmark[key] * TIME_UNITS[benchmark.get("time_unit", "ns")]
+
+
+def relative(old, new):
+    return (new - old) / old if old != 0 else (0.0 if new == 0 else float("inf"))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline")
+    parser.add_argument("contender")
+    parser.add_argument("--threshold", type=float, default=0.05, help="allowed relative slowdown ( default: 0.05 )")
+    parser.add_argument("--time", choices=("real_time", "cpu_time"), default="real_time")
+    parser.add_argument("--statistic", default="median", help="aggregate used with repetitions")
+    parser.add_argument("--allow-missing", action="store_true",
+                        help="don't flag the benchmarks of the baseline missing from the contender")
+    args = parser.parse_args()
+
+    baseline  = load(args.baseline, args.statistic)
+    contender = load(args.contender, args.statistic)
+
+    flagged = []
+    print(f"{'benchmark':<70} {'baseline':>12} {'contender':>12} {'change':>8}")
+
+    for name, new in contender.items():
+        old = baseline.get(name)
+        if old is None:
+            print(f"{name:<70} {'-':>12} {seconds(new, args.time):>12.3g} {'new':>8}")
+            continue
+
+        change = relative(seconds(old, args.time), seconds(new, args.time))
+        reasons = [f"time +{change:.1%}"] if change > args.threshold else []
+
+        for counter in MEMORY_COUNTERS:
+            if counter in old and counter in new and relative(old[counter], new[counter]) > args.threshold:
+                reasons.append(f"{counter} {old[counter]:.0f} -> {new[counter]:.0f}")
+
+        for counter in LAYOUT_COUNTERS:
+            if counter in old and counter in new and new[counter] > old[counter]:
+                reasons.append(f"{counter} {old[counter]:.0f} -> {new[counter]:.0f}")
+
+        mark = "  <-- " + ", ".join(reasons) if reasons else ""
+        print(f"{name:<70} {seconds(old, args.time):>12.3g} {seconds(new, args.time):>12.3g} {change:>+8.1%}{mark}")
+
+        if reasons: flagged.append(name)
+
+    missing = sorted(baseline.keys() - contender.keys())
+    for name in missing:
+        print(f"{name:<70} missing from the contender" + ("" if args.allow_missing else "  <-- missing"))
+
+    if not args.allow_missing: flagged.extend(missing)
+
+    if flagged:
+        print(f"\n{len(flagged)} benchmark(s) regressed beyond {args.threshold:.0%}, grew in size or are missing")
+        return 1
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
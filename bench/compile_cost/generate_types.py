@@ -0,0 +1,65 @@
+#!/usr/bin/env python3
+#  ------------------------------------
+#      Copyright (C) 2018 MO ELomari
+#  ------------------------------------
+
+"""Generates a translation unit instantiating N distinct compressed_pair types.
+
+The types cycle through the four compressed_pair_impl specializations
+( value/value, empty/value, value/empty and empty/empty ) and each of them is
+constructed, copied, swapped, compared and accessed through a structured
+binding, the way a typical user of the header does. --without-comparisons
+leaves out the comparisons, to measure the headers older than the comparison
+operators accepting members of unrelated types.
+"""
+
+import argparse
+import sys
+
+
+def members(index, count):
+    kind = index % 4
+    if kind == 0: return f"v{index}", f"v{index}"
+    if kind == 1: return f"e{index}", f"v{index}"
+    if kind == 2: return f"v{index}", f"e{index}"
+    return f"e{index}", f"e{(index + 1) % count}"
+
+
+def generate(count, header, comparisons=True):
+    lines = [f'#include "{header}"', ""]
+
+    for i in range(count):
+        lines.append(f"struct e{i} {{ friend auto operator<=>(const e{i}&, const e{i}&) = default; }};")
+        lines.append(f"struct v{i} {{ int x; friend auto operator<=>(const v{i}&, const v{i}&) = default; }};")
+
+    compare = " + (a == b) + (a < b)" if comparisons else ""
+
+    lines += ["", "auto main() -> int", "{", "    int result = 0;"]
+    for i in range(count):
+        first, second = members(i, count)
+        lines.append(f"    {{ using P = compressed_pair<{first}, {second}>; "
+                     "P a; P b = a; a.swap(b); auto& [x, y] = a; "
+                     f"result += sizeof(x) + sizeof(y){compare}; }}")
+    lines += ["    return result;", "}", ""]
+
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--types", type=int, default=2000, help="number of compressed_pair types")
+    parser.add_argument("--header", default="compressed_pair.hxx", help="header to include")
+    parser.add_argument("--without-comparisons", action="store_true", help="don't compare the pairs")
+    parser.add_argument("--out", help="output file ( default: stdout )")
+    args = parser.parse_args()
+
+    source = generate(args.types, args.header, not args.without_comparisons)
+    if args.out is None:
+        sys.stdout.write(source)
+    else:
+        with open(args.out, "w") as out:
+            out.write(source)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+#  ------------------------------------
+#      Copyright (C) 2018 MO ELomari
+#  ------------------------------------
+
+"""Measures the compile cost of N distinct compressed_pair types.
+
+The translation unit of generate_types.py is compiled --runs times, the wall
+time is the median of the runs and the memory is the peak RSS of the compiler
+( the largest of the runs ). The result is written in the json format of
+Google Benchmark, so that two measurements are compared with compare.py.
+"""
+
+import argparse
+import json
+import os
+import platform
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+import generate_types
+
+
+def compile_once(command):
+    start = time.perf_counter()
+    process = subprocess.Popen(command)
+    # the rusage of this child only, RUSAGE_CHILDREN would be the maximum of
+    # all the children waited for so far
+    _, status, usage = os.wait4(process.pid, 0)
+    elapsed = time.perf_counter() - start
+
+    if os.waitstatus_to_exitcode(status) != 0:
+        sys.exit(f"compilation failed: {' '.join(command)}")
+
+    # ru_maxrss is in kilobytes on Linux
+    return elapsed, usage.ru_maxrss * 1024
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--compiler", default=os.environ.get("CXX", "c++"))
+    parser.add_argument("--include-dir", required=True, help="directory of compressed_pair.hxx")
+    parser.add_argument("--types", type=int, default=2000)
+    parser.add_argument("--runs", type=int, default=5)
+    parser.add_argument("--flags", default="-std=c++20 -O0", help="compiler flags")
+    parser.add_argument("--without-comparisons", action="store_true", help="don't compare the pairs")
+    parser.add_argument("--out", help="json output file ( default: stdout )")
+    args = parser.parse_args()
+
+    header = os.path.join(os.path.abspath(args.include_dir), "compressed_pair.hxx")
+
+    with tempfile.TemporaryDirectory() as directory:
+        source = os.path.join(directory, "compile_cost.cpp")
+        with open(source, "w") as out:
+            out.write(generate_types.generate(args.types, header, not args.without_comparisons))
+
+        command = [args.compiler, *args.flags.split(), "-c", source, "-o", os.path.join(directory, "compile_cost.o")]
+        runs = [compile_once(command) for _ in range(args.runs)]
+
+    wall_time = statistics.median(elapsed for elapsed, _ in runs)
+    max_rss   = max(rss for _, rss in runs)
+
+    result = {
+        "context": {
+            "host_name": platform.node(),
+            "compiler": args.compiler,
+            "flags": args.flags,
+            "runs": args.runs,
+            "comparisons": not args.without_comparisons,
+        },
+        "benchmarks": [{
+            "name": f"compile_cost/{args.types}",
+            "run_type": "iteration",
+            "iterations": args.runs,
+            "real_time": wall_time * 1e3,
+            "cpu_time": wall_time * 1e3,
+            "time_unit": "ms",
+            "max_rss": max_rss,
+        }],
+    }
+
+    text = json.dumps(result, indent=2)
+    if args.out is None:
+        print(text)
+    else:
+        with open(args.out, "w") as out:
+            out.write(text + "\n")
+        print(f"compile_cost/{args.types}: {wall_time * 1e3:.0f} ms, max rss {max_rss / 2**20:.1f} MiB")
+
+
+if __name__ == "__main__":
+    main()
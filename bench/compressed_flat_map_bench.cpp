@@ -0,0 +1,128 @@
+//  ------------------------------------
+//      Copyright (C) 2018 MO ELomari
+//  ------------------------------------
+
+// insertion and lookups of 1M to 100M u64 -> u64 elements in a compressed_flat_map,
+// against std::unordered_map:
+//   - insert: a map grown from empty to the size, rehashes included,
+//   - find_hit/find_miss: 1M lookups of random keys which are/aren't in a map
+//     of the size, the lookups are the items of the throughput.
+// the largest size is COMPRESSED_PAIR_BENCH_MAX_ELEMENTS ( a std::unordered_map
+// of 100M elements takes ~5 GiB ).
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "compressed_flat_map.hxx"
+
+
+#if not defined(COMPRESSED_PAIR_BENCH_MAX_ELEMENTS)
+#define COMPRESSED_PAIR_BENCH_MAX_ELEMENTS 100'000'000
+#endif
+
+
+namespace {
+
+constexpr std::size_t lookup_count = 1'000'000;
+
+// distinct keys spread over the whole u64 range ( the multiplication by an
+// odd constant is a bijection ), the keys of a miss are odd, the others even
+constexpr auto key_at(std::uint64_t index) noexcept -> std::uint64_t
+{
+    return (index * 0x9e37'79b9'7f4a'7c15u) << 1;
+}
+
+template <typename Map>
+auto make_map(std::size_t size) -> Map
+{
+    Map map;
+    for (std::size_t i = 0; i != size; ++i) map.try_emplace(key_at(i), i);
+    return map;
+}
+
+// std::pair has a second member, compressed_pair a second() function
+template <typename Element>
+auto mapped_of(const Element& element) -> std::uint64_t
+{
+    if constexpr (requires { element.second(); }) return element.second();
+    else                                          return element.second;
+}
+
+auto make_lookups(std::size_t size, bool hit) -> std::vector<std::uint64_t>
+{
+    std::mt19937_64 random(42);
+    std::uniform_int_distribution<std::size_t> index(0, size - 1);
+
+    std::vector<std::uint64_t> keys(lookup_count);
+    for (auto& key : keys) key = key_at(index(random)) | (hit ? 0 : 1);
+    return keys;
+}
+
+
+template <typename Map>
+void insert(benchmark::State& state)
+{
+    const auto size = static_cast<std::size_t>(state.range(0));
+
+    for (auto _ : state)
+    {
+        auto map = make_map<Map>(size);
+        benchmark::DoNotOptimize(map);
+
+        state.PauseTiming();
+        map = Map();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * size));
+}
+
+template <typename Map>
+void lookup(benchmark::State& state, bool hit)
+{
+    const auto size = static_cast<std::size_t>(state.range(0));
+    const auto map  = make_map<Map>(size);
+    const auto keys = make_lookups(size, hit);
+
+    for (auto _ : state)
+    {
+        std::uint64_t sum = 0;
+        for (const auto key : keys)
+        {
+            if (const auto it = map.find(key); it != map.end()) sum += mapped_of(*it);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * lookup_count));
+}
+
+template <typename Map>
+void find_hit(benchmark::State& state) { lookup<Map>(state, true); }
+
+template <typename Map>
+void find_miss(benchmark::State& state) { lookup<Map>(state, false); }
+
+
+void apply_sizes(benchmark::internal::Benchmark* bench)
+{
+    for (std::int64_t size = 1'000'000; size <= COMPRESSED_PAIR_BENCH_MAX_ELEMENTS; size *= 10) bench->Arg(size);
+    bench->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+}  // namespace
+
+
+BENCHMARK_TEMPLATE(insert, compressed_flat_map<std::uint64_t, std::uint64_t>)->Apply(apply_sizes);
+BENCHMARK_TEMPLATE(insert, std::unordered_map<std::uint64_t, std::uint64_t>)->Apply(apply_sizes);
+
+BENCHMARK_TEMPLATE(find_hit, compressed_flat_map<std::uint64_t, std::uint64_t>)->Apply(apply_sizes);
+BENCHMARK_TEMPLATE(find_hit, std::unordered_map<std::uint64_t, std::uint64_t>)->Apply(apply_sizes);
+
+BENCHMARK_TEMPLATE(find_miss, compressed_flat_map<std::uint64_t, std::uint64_t>)->Apply(apply_sizes);
+BENCHMARK_TEMPLATE(find_miss, std::unordered_map<std::uint64_t, std::uint64_t>)->Apply(apply_sizes);
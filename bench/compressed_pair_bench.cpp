@@ -0,0 +1,229 @@
+//  ------------------------------------
+//      Copyright (C) 2018 MO ELomari
+//  ------------------------------------
+
+// construct, copy, move, swap, lexicographical_compare and structured binding
+// access of the four compressed_pair_impl specializations, against std::pair
+// and a struct with [[no_unique_address]] members. every benchmark reports the
+// sizeof and alignof of the pair as counters, so that compare.py also flags a
+// layout regression.
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "compressed_pair.hxx"
+
+
+namespace {
+
+constexpr std::size_t element_count = 4096;
+
+// stateless members, ordered so that all the pairs are totally ordered
+struct empty1 { auto operator<=>(const empty1&) const = default; };
+struct empty2 { auto operator<=>(const empty2&) const = default; };
+
+template <typename T1, typename T2>
+struct no_unique_address_pair
+{
+    [[no_unique_address]] T1 first;
+    [[no_unique_address]] T2 second;
+
+    auto operator<=>(const no_unique_address_pair&) const = default;
+};
+
+
+// value of the i-th element of a member of type T
+template <typename T>
+auto make_value(std::size_t index) -> T
+{
+    if constexpr (std::is_empty<T>::value) return T();
+    else                                   return static_cast<T>(index * 2654435761u);
+}
+
+// member types of the three pair templates
+template <typename>
+struct pair_members;
+
+template <template <typename, typename> class Pair, typename T1, typename T2>
+struct pair_members<Pair<T1, T2>>
+{
+    using first_type  = T1;
+    using second_type = T2;
+};
+
+template <typename Pair>
+auto make_pair_at(std::size_t index) -> Pair
+{
+    using first_type  = typename pair_members<Pair>::first_type;
+    using second_type = typename pair_members<Pair>::second_type;
+
+    return Pair{make_value<first_type>(index), make_value<second_type>(index / 2)};
+}
+
+template <typename Pair>
+auto make_pairs() -> std::vector<Pair>
+{
+    std::vector<Pair> pairs;
+    pairs.reserve(element_count);
+    for (std::size_t i = 0; i != element_count; ++i) pairs.push_back(make_pair_at<Pair>(i));
+    return pairs;
+}
+
+template <typename T>
+auto sum_of(const T& value) -> std::uint64_t
+{
+    if constexpr (std::is_empty<T>::value) return 1;
+    else                                   return static_cast<std::uint64_t>(value);
+}
+
+template <typename Pair>
+auto less(const Pair& lhs, const Pair& rhs) -> bool
+{
+    if constexpr (requires { lexicographical_compare(lhs, rhs); }) return lexicographical_compare(lhs, rhs);
+    else                                                           return lhs < rhs;
+}
+
+template <typename Pair>
+void set_layout_counters(benchmark::State& state)
+{
+    state.counters["sizeof"]  = sizeof(Pair);
+    state.counters["alignof"] = alignof(Pair);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * element_count));
+}
+
+
+
+template <typename Pair>
+void construct(benchmark::State& state)
+{
+    auto storage = std::make_unique_for_overwrite<std::byte[]>(element_count * sizeof(Pair));
+    auto* pairs  = reinterpret_cast<Pair*>(storage.get());
+
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i != element_count; ++i) ::new (static_cast<void*>(pairs + i)) Pair(make_pair_at<Pair>(i));
+        benchmark::DoNotOptimize(pairs);
+        benchmark::ClobberMemory();
+    }
+
+    set_layout_counters<Pair>(state);
+}
+
+template <typename Pair>
+void copy(benchmark::State& state)
+{
+    const auto source = make_pairs<Pair>();
+    auto destination  = make_pairs<Pair>();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(source.data());
+        for (std::size_t i = 0; i != element_count; ++i) destination[i] = source[i];
+        benchmark::ClobberMemory();
+    }
+
+    set_layout_counters<Pair>(state);
+}
+
+template <typename Pair>
+void move(benchmark::State& state)
+{
+    auto source      = make_pairs<Pair>();
+    auto destination = make_pairs<Pair>();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(source.data());
+        for (std::size_t i = 0; i != element_count; ++i) destination[i] = std::move(source[i]);
+        benchmark::ClobberMemory();
+    }
+
+    set_layout_counters<Pair>(state);
+}
+
+template <typename Pair>
+void swap(benchmark::State& state)
+{
+    auto lhs = make_pairs<Pair>();
+    auto rhs = make_pairs<Pair>();
+
+    for (auto _ : state)
+    {
+        using std::swap;
+        for (std::size_t i = 0; i != element_count; ++i) swap(lhs[i], rhs[i]);
+        benchmark::ClobberMemory();
+    }
+
+    set_layout_counters<Pair>(state);
+}
+
+template <typename Pair>
+void compare(benchmark::State& state)
+{
+    const auto pairs = make_pairs<Pair>();
+
+    for (auto _ : state)
+    {
+        std::size_t count = 0;
+        for (std::size_t i = 1; i != element_count; ++i) count += less(pairs[i - 1], pairs[i]);
+        benchmark::DoNotOptimize(count);
+    }
+
+    set_layout_counters<Pair>(state);
+}
+
+template <typename Pair>
+void structured_binding(benchmark::State& state)
+{
+    const auto pairs = make_pairs<Pair>();
+
+    for (auto _ : state)
+    {
+        std::uint64_t sum = 0;
+        for (const auto& [first, second] : pairs) sum += sum_of(first) + sum_of(second);
+        benchmark::DoNotOptimize(sum);
+    }
+
+    set_layout_counters<Pair>(state);
+}
+
+
+
+template <typename Pair>
+void register_pair(const std::string& name)
+{
+    benchmark::RegisterBenchmark(("construct/"          + name).c_str(), construct<Pair>);
+    benchmark::RegisterBenchmark(("copy/"               + name).c_str(), copy<Pair>);
+    benchmark::RegisterBenchmark(("move/"               + name).c_str(), move<Pair>);
+    benchmark::RegisterBenchmark(("swap/"               + name).c_str(), swap<Pair>);
+    benchmark::RegisterBenchmark(("compare/"            + name).c_str(), compare<Pair>);
+    benchmark::RegisterBenchmark(("structured_binding/" + name).c_str(), structured_binding<Pair>);
+}
+
+// the same members in the three pairs
+template <typename T1, typename T2>
+void register_specialization(const std::string& members)
+{
+    register_pair<compressed_pair<T1, T2>>("compressed_pair<" + members + ">");
+    register_pair<std::pair<T1, T2>>("std::pair<" + members + ">");
+    register_pair<no_unique_address_pair<T1, T2>>("no_unique_address_pair<" + members + ">");
+}
+
+[[maybe_unused]] const bool registered = [] {
+    register_specialization<std::uint64_t, std::uint32_t>("u64,u32");  // #1
+    register_specialization<empty1, std::uint64_t>("empty1,u64");      // #2
+    register_specialization<std::uint64_t, empty2>("u64,empty2");      // T2 empty
+    register_specialization<empty1, empty2>("empty1,empty2");          // #3
+    return true;
+}();
+
+}  // namespace
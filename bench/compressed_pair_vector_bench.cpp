@@ -0,0 +1,144 @@
+//  ------------------------------------
+//      Copyright (C) 2018 MO ELomari
+//  ------------------------------------
+
+// filter/sum over the elements of a compressed_pair_vector ( structure of
+// arrays ), through the proxy iterator and through the firsts()/seconds()
+// spans, against a std::vector of compressed_pair and of std::pair ( array
+// of structures ):
+//   - filter_sum: sum of the second members whose first member passes a filter,
+//   - sum_firsts: sum of the first members only, the second member is a
+//     64 bytes payload that an array of structures loads for nothing.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "compressed_pair_vector.hxx"
+
+
+namespace {
+
+struct payload
+{
+    std::array<double, 8> values;
+};
+
+template <typename T>
+auto make_second(std::uint32_t value) -> T
+{
+    if constexpr (std::is_same<T, payload>::value) return payload{{static_cast<double>(value)}};
+    else                                           return static_cast<T>(value);
+}
+
+template <typename Container, typename T2>
+auto make_container(std::size_t size) -> Container
+{
+    std::mt19937 random(42);
+
+    Container values;
+    values.reserve(size);
+    for (std::size_t i = 0; i != size; ++i)
+    {
+        const auto key = static_cast<std::uint32_t>(random());
+        values.emplace_back(key, make_second<T2>(key));
+    }
+    return values;
+}
+
+// half of the keys pass the filter
+constexpr auto passes(std::uint32_t key) noexcept -> bool { return key < 0x8000'0000u; }
+
+template <typename Container>
+void set_counters(benchmark::State& state)
+{
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+
+
+// through the proxies ( structured bindings of compressed_pair<T1&, T2&> ) or
+// the references to the elements of an array of structures
+template <typename Container>
+void filter_sum(benchmark::State& state)
+{
+    const auto values = make_container<Container, double>(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        double sum = 0;
+        for (const auto& [key, value] : values)
+        {
+            if (passes(key)) sum += value;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+
+    set_counters<Container>(state);
+}
+
+void filter_sum_spans(benchmark::State& state)
+{
+    using container_t = compressed_pair_vector<std::uint32_t, double>;
+    const auto values = make_container<container_t, double>(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        const auto keys    = values.firsts();
+        const auto seconds = values.seconds();
+
+        double sum = 0;
+        for (std::size_t i = 0; i != keys.size(); ++i) sum += passes(keys[i]) ? seconds[i] : 0.0;
+        benchmark::DoNotOptimize(sum);
+    }
+
+    set_counters<container_t>(state);
+}
+
+template <typename Container>
+void sum_firsts(benchmark::State& state)
+{
+    const auto values = make_container<Container, payload>(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        std::uint64_t sum = 0;
+        for (const auto& [key, value] : values) sum += key;
+        benchmark::DoNotOptimize(sum);
+    }
+
+    set_counters<Container>(state);
+}
+
+void sum_firsts_spans(benchmark::State& state)
+{
+    using container_t = compressed_pair_vector<std::uint32_t, payload>;
+    const auto values = make_container<container_t, payload>(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        std::uint64_t sum = 0;
+        for (const auto key : values.firsts()) sum += key;
+        benchmark::DoNotOptimize(sum);
+    }
+
+    set_counters<container_t>(state);
+}
+
+}  // namespace
+
+
+BENCHMARK_TEMPLATE(filter_sum, compressed_pair_vector<std::uint32_t, double>)->Range(1 << 10, 1 << 22);
+BENCHMARK(filter_sum_spans)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(filter_sum, std::vector<compressed_pair<std::uint32_t, double>>)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(filter_sum, std::vector<std::pair<std::uint32_t, double>>)->Range(1 << 10, 1 << 22);
+
+BENCHMARK_TEMPLATE(sum_firsts, compressed_pair_vector<std::uint32_t, payload>)->Range(1 << 10, 1 << 20);
+BENCHMARK(sum_firsts_spans)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(sum_firsts, std::vector<compressed_pair<std::uint32_t, payload>>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(sum_firsts, std::vector<std::pair<std::uint32_t, payload>>)->Range(1 << 10, 1 << 20);
@@ -0,0 +1,213 @@
+//  ------------------------------------
+//      Copyright (C) 2018 MO ELomari
+//  ------------------------------------
+
+// allocations of a request handler: the objects of a request are allocated,
+// written and all freed at the end of the request, through
+//   - std::allocator ( malloc ),
+//   - a std::pmr::monotonic_buffer_resource and a monotonic_arena, both served
+//     from a buffer reused by every request and released at its end,
+//   - a fixed_pool, the objects are freed one by one to its free list.
+//
+//   - alloc_free: throughput of requests of 256 objects, the allocations are
+//     the items,
+//   - resident_memory: growth of the resident set ( /proc/self/statm ) while
+//     1M objects are alive, reported by the rss counter in bytes and rss per
+//     object. the free memory of the heap is returned to the system first
+//     ( malloc_trim ), so that the objects freed by the previous benchmarks
+//     don't hide the growth.
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include <benchmark/benchmark.h>
+
+#include "memory_arena.hxx"
+
+
+namespace {
+
+constexpr std::size_t objects_per_request = 256;
+constexpr std::size_t resident_objects    = 1'000'000;
+
+// a small object of a request, 40 bytes
+struct request_object
+{
+    std::uint64_t id;
+    std::array<std::uint64_t, 4> payload;
+};
+
+// buffer reused by the requests of the monotonic resources, large enough for a request
+constexpr std::size_t request_buffer_size = 2 * objects_per_request * sizeof(request_object);
+
+
+// resident set of the process in bytes, -1 where it can't be read
+auto resident_bytes() -> std::int64_t
+{
+#if defined(__linux__)
+    std::ifstream statm("/proc/self/statm");
+    std::int64_t size = 0;
+    std::int64_t resident = -1;
+    if (not (statm >> size >> resident)) return -1;
+    return resident * static_cast<std::int64_t>(::sysconf(_SC_PAGESIZE));
+#else
+    return -1;
+#endif
+}
+
+void trim_heap() noexcept
+{
+#if defined(__GLIBC__)
+    ::malloc_trim(0);
+#endif
+}
+
+
+// the allocator of a strategy, and end_request() which reclaims the memory
+// of a request ( the objects are already deallocated )
+struct new_delete
+{
+    using allocator_type = std::allocator<request_object>;
+
+    auto allocator() noexcept -> allocator_type { return {}; }
+    void end_request() noexcept {}
+};
+
+struct pmr_monotonic
+{
+    using allocator_type = std::pmr::polymorphic_allocator<request_object>;
+
+    auto allocator() noexcept -> allocator_type { return &this->resource; }
+    void end_request() noexcept { this->resource.release(); }
+
+    std::vector<std::byte> buffer = std::vector<std::byte>(request_buffer_size);
+    std::pmr::monotonic_buffer_resource resource{buffer.data(), buffer.size()};
+};
+
+struct arena
+{
+    using allocator_type = arena_allocator<request_object>;
+
+    auto allocator() noexcept -> allocator_type { return this->resource; }
+    void end_request() noexcept { this->resource.release(); }
+
+    std::vector<std::byte> buffer = std::vector<std::byte>(request_buffer_size);
+    monotonic_arena resource{buffer.data(), buffer.size()};
+};
+
+struct pool
+{
+    using allocator_type = pool_allocator<request_object>;
+
+    auto allocator() noexcept -> allocator_type { return this->resource; }
+    void end_request() noexcept {}
+
+    fixed_pool resource{sizeof(request_object), alignof(request_object)};
+};
+
+
+template <typename Allocator>
+void allocate_objects(Allocator& allocator, std::vector<request_object*>& objects, std::size_t count)
+{
+    for (std::size_t i = 0; i != count; ++i)
+    {
+        auto* object = std::allocator_traits<Allocator>::allocate(allocator, 1);
+        object->id = i;
+        objects.push_back(object);
+    }
+}
+
+template <typename Allocator>
+void deallocate_objects(Allocator& allocator, std::vector<request_object*>& objects)
+{
+    for (auto* object : objects) std::allocator_traits<Allocator>::deallocate(allocator, object, 1);
+    objects.clear();
+}
+
+
+template <typename Strategy>
+void alloc_free(benchmark::State& state)
+{
+    Strategy strategy;
+    auto allocator = strategy.allocator();
+
+    std::vector<request_object*> objects;
+    objects.reserve(objects_per_request);
+
+    for (auto _ : state)
+    {
+        allocate_objects(allocator, objects, objects_per_request);
+        benchmark::DoNotOptimize(objects.data());
+        benchmark::ClobberMemory();
+
+        deallocate_objects(allocator, objects);
+        strategy.end_request();
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * objects_per_request));
+}
+
+template <typename Strategy>
+void resident_memory(benchmark::State& state)
+{
+    std::vector<request_object*> objects;
+    objects.reserve(resident_objects);
+
+    std::int64_t growth = 0;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        Strategy strategy;
+        auto allocator = strategy.allocator();
+        trim_heap();
+        const auto before = resident_bytes();
+        state.ResumeTiming();
+
+        allocate_objects(allocator, objects, resident_objects);
+        benchmark::ClobberMemory();
+
+        state.PauseTiming();
+        const auto after = resident_bytes();
+        if (before < 0 or after < 0)
+        {
+            state.SkipWithError("the resident set size can't be read on this system");
+            break;
+        }
+        growth = std::max(growth, after - before);
+
+        deallocate_objects(allocator, objects);
+        strategy.end_request();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * resident_objects));
+    state.counters["rss"] = static_cast<double>(growth);
+    state.counters["rss_per_object"] = static_cast<double>(growth) / resident_objects;
+}
+
+}  // namespace
+
+
+BENCHMARK_TEMPLATE(alloc_free, new_delete);
+BENCHMARK_TEMPLATE(alloc_free, pmr_monotonic);
+BENCHMARK_TEMPLATE(alloc_free, arena);
+BENCHMARK_TEMPLATE(alloc_free, pool);
+
+BENCHMARK_TEMPLATE(resident_memory, new_delete)->Unit(benchmark::kMillisecond)->Iterations(5);
+BENCHMARK_TEMPLATE(resident_memory, pmr_monotonic)->Unit(benchmark::kMillisecond)->Iterations(5);
+BENCHMARK_TEMPLATE(resident_memory, arena)->Unit(benchmark::kMillisecond)->Iterations(5);
+BENCHMARK_TEMPLATE(resident_memory, pool)->Unit(benchmark::kMillisecond)->Iterations(5);
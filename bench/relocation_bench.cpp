@@ -0,0 +1,117 @@
+//  ------------------------------------
+//      Copyright (C) 2018 MO ELomari
+//  ------------------------------------
+
+// growth and bulk copy of a std::vector of 10M pairs, against a memcpy of the
+// same number of bytes. a trivially copyable ( and relocatable ) pair should
+// copy and grow at memcpy speed.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "compressed_pair.hxx"
+
+
+namespace {
+
+constexpr std::size_t pair_count = 10'000'000;
+
+template <typename Pair>
+void set_bytes_counters(benchmark::State& state)
+{
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * pair_count * sizeof(Pair)));
+    state.counters["sizeof"] = sizeof(Pair);
+}
+
+template <typename Pair>
+auto make_pairs() -> std::vector<Pair>
+{
+    std::vector<Pair> pairs;
+    pairs.reserve(pair_count);
+    for (std::size_t i = 0; i != pair_count; ++i) pairs.emplace_back(static_cast<int>(i), static_cast<float>(i));
+    return pairs;
+}
+
+
+// baseline, a memcpy of the bytes of 10M compressed_pair<int, float> into a
+// new allocation, as a copy of the vector does
+void memcpy_pairs(benchmark::State& state)
+{
+    using pair_t = compressed_pair<int, float>;
+
+    const auto source = make_pairs<pair_t>();
+
+    for (auto _ : state)
+    {
+        auto destination = std::make_unique_for_overwrite<std::byte[]>(pair_count * sizeof(pair_t));
+        std::memcpy(destination.get(), source.data(), pair_count * sizeof(pair_t));
+        benchmark::DoNotOptimize(destination.get());
+    }
+
+    set_bytes_counters<pair_t>(state);
+}
+
+template <typename Pair>
+void copy_vector(benchmark::State& state)
+{
+    const auto source = make_pairs<Pair>();
+
+    for (auto _ : state)
+    {
+        std::vector<Pair> copy = source;
+        benchmark::DoNotOptimize(copy.data());
+    }
+
+    set_bytes_counters<Pair>(state);
+}
+
+// copy into an existing vector, no allocation
+template <typename Pair>
+void assign_vector(benchmark::State& state)
+{
+    const auto source = make_pairs<Pair>();
+    auto destination  = make_pairs<Pair>();
+
+    for (auto _ : state)
+    {
+        destination.assign(source.begin(), source.end());
+        benchmark::DoNotOptimize(destination.data());
+    }
+
+    set_bytes_counters<Pair>(state);
+}
+
+// the relocation of the elements on every reallocation is the difference
+// with a copy
+template <typename Pair>
+void grow_vector(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        std::vector<Pair> pairs;
+        for (std::size_t i = 0; i != pair_count; ++i) pairs.emplace_back(static_cast<int>(i), static_cast<float>(i));
+        benchmark::DoNotOptimize(pairs.data());
+    }
+
+    set_bytes_counters<Pair>(state);
+}
+
+}  // namespace
+
+
+BENCHMARK(memcpy_pairs)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(copy_vector, compressed_pair<int, float>)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(copy_vector, std::pair<int, float>)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(assign_vector, compressed_pair<int, float>)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(assign_vector, std::pair<int, float>)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(grow_vector, compressed_pair<int, float>)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(grow_vector, std::pair<int, float>)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,350 @@
+//  ------------------------------------
+//      Copyright (C) 2018 MO ELomari
+//  ------------------------------------
+
+// The compressed buffer class is a minimal allocator-aware dynamic array: the
+// allocator and the data pointer are held in a compressed_pair, so that with a
+// stateless allocator ( std::allocator ) the buffer is 3 words ( data pointer,
+// size and capacity ) and a stateful one ( arena_allocator, pool_allocator )
+// only adds its own state.
+//
+// the elements are contiguous and accessed through raw pointers, trivially
+// relocatable elements are moved with memcpy when the buffer grows.
+
+#ifndef __COMPRESSED_BUFFER_HXX__
+#define __COMPRESSED_BUFFER_HXX__
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "compressed_pair.hxx"
+
+
+// MAIN CLASS
+template <typename T, typename Allocator = std::allocator<T>>
+class compressed_buffer
+{
+    using traits_t = std::allocator_traits<Allocator>;
+
+    static_assert(std::is_same<typename traits_t::value_type, T>::value,
+                  "the allocator of a compressed_buffer must allocate T");
+
+public:
+    using value_type      = T;
+    using allocator_type  = Allocator;
+    using pointer         = typename traits_t::pointer;
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using iterator        = T*;
+    using const_iterator  = const T*;
+
+
+public:
+    // Default constructor. Owns nothing
+    compressed_buffer() noexcept(std::is_nothrow_default_constructible<Allocator>::value)
+        requires(std::is_default_constructible<Allocator>::value)
+        : m_allocator_and_data(Allocator(), pointer())
+    {
+    }
+
+    explicit compressed_buffer(const Allocator& allocator) noexcept
+        : m_allocator_and_data(allocator, pointer())
+    {
+    }
+
+    // allocates room for capacity elements
+    explicit compressed_buffer(size_type capacity, const Allocator& allocator = Allocator())
+        : compressed_buffer(allocator)
+    {
+        this->reserve(capacity);
+    }
+
+    compressed_buffer(const compressed_buffer& other)
+        requires(std::is_copy_constructible<T>::value)
+        : compressed_buffer(traits_t::select_on_container_copy_construction(other.get_allocator()))
+    {
+        this->reserve(other.size());
+        for (const auto& value : other) this->emplace_back(value);
+    }
+
+    compressed_buffer(compressed_buffer&& other) noexcept
+        : m_allocator_and_data(std::move(other.allocator()), std::exchange(other.data_pointer(), pointer())),
+          m_size(std::exchange(other.m_size, 0)),
+          m_capacity(std::exchange(other.m_capacity, 0))
+    {
+    }
+
+    ~compressed_buffer()
+    {
+        this->clear();
+        this->release();
+    }
+
+    auto operator=(const compressed_buffer& rhs) -> compressed_buffer&
+        requires(std::is_copy_constructible<T>::value)
+    {
+        if (this == &rhs) return *this;
+
+        this->clear();
+        if constexpr (traits_t::propagate_on_container_copy_assignment::value)
+        {
+            if (this->allocator() != rhs.allocator()) this->release();
+            this->allocator() = rhs.allocator();
+        }
+
+        this->reserve(rhs.size());
+        for (const auto& value : rhs) this->emplace_back(value);
+        return *this;
+    }
+
+    auto operator=(compressed_buffer&& rhs) noexcept(
+        traits_t::propagate_on_container_move_assignment::value or
+        traits_t::is_always_equal::value) -> compressed_buffer&
+    {
+        if (this == &rhs) return *this;
+
+        this->clear();
+        if constexpr (not traits_t::propagate_on_container_move_assignment::value and
+                      not traits_t::is_always_equal::value)
+        {
+            // the memory of rhs can't be deallocated through this allocator
+            if (this->allocator() != rhs.allocator())
+            {
+                this->reserve(rhs.size());
+                for (auto& value : rhs) this->emplace_back(std::move(value));
+                rhs.clear();
+                return *this;
+            }
+        }
+
+        this->release();
+        if constexpr (traits_t::propagate_on_container_move_assignment::value)
+        {
+            this->allocator() = std::move(rhs.allocator());
+        }
+
+        this->data_pointer() = std::exchange(rhs.data_pointer(), pointer());
+        this->m_size         = std::exchange(rhs.m_size, 0);
+        this->m_capacity     = std::exchange(rhs.m_capacity, 0);
+        return *this;
+    }
+
+
+public:
+    auto get_allocator() const noexcept -> Allocator { return this->allocator(); }
+
+
+public:
+    auto operator[](size_type index)       noexcept ->       T& { return this->data()[index]; }
+    auto operator[](size_type index) const noexcept -> const T& { return this->data()[index]; }
+
+    auto front()       noexcept ->       T& { return this->data()[0]; }
+    auto front() const noexcept -> const T& { return this->data()[0]; }
+
+    auto back()       noexcept ->       T& { return this->data()[this->m_size - 1]; }
+    auto back() const noexcept -> const T& { return this->data()[this->m_size - 1]; }
+
+    auto data()       noexcept ->       T* { return std::to_address(this->data_pointer()); }
+    auto data() const noexcept -> const T* { return std::to_address(this->data_pointer()); }
+
+
+public:
+    auto begin()       noexcept -> iterator       { return this->data(); }
+    auto begin() const noexcept -> const_iterator { return this->data(); }
+
+    auto end()       noexcept -> iterator       { return this->data() + this->m_size; }
+    auto end() const noexcept -> const_iterator { return this->data() + this->m_size; }
+
+    auto cbegin() const noexcept -> const_iterator { return this->begin(); }
+    auto cend()   const noexcept -> const_iterator { return this->end(); }
+
+
+public:
+    auto size()     const noexcept -> size_type { return this->m_size; }
+    auto capacity() const noexcept -> size_type { return this->m_capacity; }
+    auto empty()    const noexcept -> bool      { return this->m_size == 0; }
+
+    // grows the buffer to hold at least capacity elements
+    void reserve(size_type capacity)
+    {
+        if (capacity <= this->m_capacity) return;
+
+        const auto new_data = traits_t::allocate(this->allocator(), capacity);
+        try
+        {
+            this->transfer_to(std::to_address(new_data));
+        }
+        catch (...)
+        {
+            traits_t::deallocate(this->allocator(), new_data, capacity);
+            throw;
+        }
+
+        this->adopt(new_data, capacity);
+    }
+
+    // destroys all the elements, the capacity is unchanged
+    void clear() noexcept
+    {
+        this->destroy(this->data(), this->data() + this->m_size);
+        this->m_size = 0;
+    }
+
+
+public:
+    // Appends the element constructed from std::forward<ARGS>(args)...
+    template <typename... ARGS>
+    auto emplace_back(ARGS&&... args) -> T&
+        requires(std::is_constructible<T, ARGS...>::value)
+    {
+        if (this->m_size == this->m_capacity)
+        {
+            return this->grow_and_emplace_back(std::forward<ARGS>(args)...);
+        }
+
+        traits_t::construct(this->allocator(), this->data() + this->m_size, std::forward<ARGS>(args)...);
+        return this->data()[this->m_size++];
+    }
+
+    void push_back(const T& value) { this->emplace_back(value); }
+    void push_back(T&& value)      { this->emplace_back(std::move(value)); }
+
+    void pop_back() noexcept
+    {
+        --this->m_size;
+        traits_t::destroy(this->allocator(), this->data() + this->m_size);
+    }
+
+
+public:
+    // the allocators are only exchanged if they propagate on swap
+    void swap(compressed_buffer& other) noexcept
+    {
+        if constexpr (traits_t::propagate_on_container_swap::value)
+        {
+            this->m_allocator_and_data.swap(other.m_allocator_and_data);
+        }
+        else
+        {
+            std::swap(this->data_pointer(), other.data_pointer());
+        }
+
+        std::swap(this->m_size, other.m_size);
+        std::swap(this->m_capacity, other.m_capacity);
+    }
+
+
+private:
+    auto allocator()       noexcept ->       Allocator& { return this->m_allocator_and_data.first(); }
+    auto allocator() const noexcept -> const Allocator& { return this->m_allocator_and_data.first(); }
+
+    auto data_pointer()       noexcept ->       pointer& { return this->m_allocator_and_data.second(); }
+    auto data_pointer() const noexcept -> const pointer& { return this->m_allocator_and_data.second(); }
+
+    void destroy(T* first, T* last) noexcept
+    {
+        if constexpr (not std::is_trivially_destructible<T>::value)
+        {
+            for (; first != last; ++first) traits_t::destroy(this->allocator(), first);
+        }
+    }
+
+    // moves ( or copies if the move constructor may throw ) the elements into
+    // data, the elements of this buffer are left to adopt
+    void transfer_to(T* data)
+    {
+        if constexpr (is_trivially_relocatable_v<T>)
+        {
+            if (this->m_size != 0) std::memcpy(static_cast<void*>(data), this->data(), this->m_size * sizeof(T));
+        }
+        else
+        {
+            size_type count = 0;
+            try
+            {
+                for (; count != this->m_size; ++count)
+                {
+                    traits_t::construct(this->allocator(), data + count, std::move_if_noexcept(this->data()[count]));
+                }
+            }
+            catch (...)
+            {
+                this->destroy(data, data + count);
+                throw;
+            }
+        }
+    }
+
+    // ends the lifetime of the elements after transfer_to and replaces the
+    // storage with data
+    void adopt(pointer data, size_type capacity) noexcept
+    {
+        if constexpr (not is_trivially_relocatable_v<T>)
+        {
+            this->destroy(this->data(), this->data() + this->m_size);
+        }
+
+        this->release();
+        this->data_pointer() = data;
+        this->m_capacity     = capacity;
+    }
+
+    template <typename... ARGS>
+    auto grow_and_emplace_back(ARGS&&... args) -> T&
+    {
+        const size_type capacity = this->m_capacity == 0 ? 16 : 2 * this->m_capacity;
+        const auto new_data = traits_t::allocate(this->allocator(), capacity);
+
+        // the new element is constructed first, the arguments may refer to
+        // elements of this buffer
+        auto* element = std::to_address(new_data) + this->m_size;
+        try
+        {
+            traits_t::construct(this->allocator(), element, std::forward<ARGS>(args)...);
+            try
+            {
+                this->transfer_to(std::to_address(new_data));
+            }
+            catch (...)
+            {
+                traits_t::destroy(this->allocator(), element);
+                throw;
+            }
+        }
+        catch (...)
+        {
+            traits_t::deallocate(this->allocator(), new_data, capacity);
+            throw;
+        }
+
+        this->adopt(new_data, capacity);
+        return this->data()[this->m_size++];
+    }
+
+    void release() noexcept
+    {
+        if (this->data_pointer() != pointer())
+        {
+            traits_t::deallocate(this->allocator(), std::exchange(this->data_pointer(), pointer()), this->m_capacity);
+        }
+
+        this->m_capacity = 0;
+    }
+
+
+private:
+    compressed_pair<Allocator, pointer> m_allocator_and_data;
+    size_type m_size     = 0;
+    size_type m_capacity = 0;
+};
+
+
+template <typename T, typename Allocator>
+void swap(compressed_buffer<T, Allocator>& lhs, compressed_buffer<T, Allocator>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+#endif
@@ -0,0 +1,758 @@
+//  ------------------------------------
+//      Copyright (C) 2018 MO ELomari
+//  ------------------------------------
+
+// The compressed flat map is an open-addressing hash table ( "swiss table"
+// layout ) whose slots are compressed_pair<Key, Value>: with an empty Value
+// type it's a hash set without any per-slot overhead. The hasher and the key
+// equality predicate are held through compressed_pair as well, so that the
+// table itself is 3 words ( control bytes pointer, size and capacity ) when
+// they are stateless.
+//
+// every slot has a control byte: empty, deleted, or the 7 low bits of the hash
+// of its key. lookups compare 16 control bytes at once ( SSE2 when available )
+// and only compare the keys of the slots whose control byte matches.
+
+#ifndef __COMPRESSED_FLAT_MAP_HXX__
+#define __COMPRESSED_FLAT_MAP_HXX__
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define COMPRESSED_FLAT_MAP_SSE2 1
+#endif
+
+#include "compressed_pair.hxx"
+
+
+namespace detail {
+
+// control byte of a slot: empty, deleted or the 7 low bits of the hash of a full slot
+using ctrl_t = std::int8_t;
+
+inline constexpr ctrl_t ctrl_empty   = -128;
+inline constexpr ctrl_t ctrl_deleted = -2;
+
+constexpr auto is_full(ctrl_t ctrl) noexcept -> bool { return ctrl >= 0; }
+
+
+// the control bytes of 16 consecutive slots, each match returns a bitmask
+// with the bit i set if the control byte i matches
+class probe_group
+{
+
+public:
+    static constexpr std::size_t width = 16;
+
+    using bitmask = std::uint16_t;
+
+
+public:
+#if defined(COMPRESSED_FLAT_MAP_SSE2)
+
+    explicit probe_group(const ctrl_t* ctrl) noexcept
+        : m_ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl)))
+    {
+    }
+
+    auto match(ctrl_t hash) const noexcept -> bitmask
+    {
+        return static_cast<bitmask>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(hash), this->m_ctrl)));
+    }
+
+    auto match_empty() const noexcept -> bitmask
+    {
+        return this->match(ctrl_empty);
+    }
+
+    // empty and deleted are the only negative values below -1
+    auto match_empty_or_deleted() const noexcept -> bitmask
+    {
+        return static_cast<bitmask>(
+            _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), this->m_ctrl)));
+    }
+
+private:
+    __m128i m_ctrl;
+
+#else
+
+    explicit probe_group(const ctrl_t* ctrl) noexcept
+    {
+        std::memcpy(this->m_ctrl, ctrl, width);
+    }
+
+    auto match(ctrl_t hash) const noexcept -> bitmask
+    {
+        bitmask mask = 0;
+        for (std::size_t i = 0; i != width; ++i) mask |= bitmask(this->m_ctrl[i] == hash) << i;
+        return mask;
+    }
+
+    auto match_empty() const noexcept -> bitmask
+    {
+        return this->match(ctrl_empty);
+    }
+
+    auto match_empty_or_deleted() const noexcept -> bitmask
+    {
+        bitmask mask = 0;
+        for (std::size_t i = 0; i != width; ++i) mask |= bitmask(this->m_ctrl[i] < -1) << i;
+        return mask;
+    }
+
+private:
+    ctrl_t m_ctrl[width];
+
+#endif
+};
+
+}  // namespace detail
+
+/** END **/
+
+
+
+// MAIN CLASS
+template <typename Key, typename Value,
+          typename Hash     = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class compressed_flat_map
+{
+
+public:
+    using key_type        = Key;
+    using mapped_type     = Value;
+    using value_type      = compressed_pair<Key, Value>;
+    using reference       = compressed_pair<const Key&, Value&>;
+    using const_reference = compressed_pair<const Key&, const Value&>;
+    using hasher          = Hash;
+    using key_equal       = KeyEqual;
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+
+public:
+    // forward iterator over the full slots. dereferencing yields a compressed_pair
+    // of references whose key is const ( as the pair<const Key, T> of the std
+    // maps ), so that the key of an element can't be modified through it.
+    template <bool Const>
+    class basic_iterator
+    {
+
+    public:
+        using iterator_concept  = std::forward_iterator_tag;
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = compressed_pair<Key, Value>;
+        using difference_type   = std::ptrdiff_t;
+        using reference         = std::conditional_t<Const, const_reference, compressed_flat_map::reference>;
+
+        // it->second() on the proxy returned by value
+        class pointer
+        {
+
+        public:
+            constexpr auto operator->() noexcept -> reference* { return &this->m_element; }
+
+        private:
+            friend class basic_iterator;
+
+            constexpr explicit pointer(reference element) noexcept : m_element(element) {}
+
+            reference m_element;
+        };
+
+        using slot_pointer = std::conditional_t<Const, const value_type*, value_type*>;
+
+
+    public:
+        constexpr basic_iterator() noexcept = default;
+
+        constexpr basic_iterator(const detail::ctrl_t* ctrl, const detail::ctrl_t* last, slot_pointer slot) noexcept
+            : m_ctrl(ctrl), m_last(last), m_slot(slot)
+        {
+            this->skip_empty();
+        }
+
+        // iterator -> const_iterator
+        template <bool OtherConst>
+        constexpr basic_iterator(const basic_iterator<OtherConst>& other) noexcept
+            requires(Const and not OtherConst)
+            : m_ctrl(other.m_ctrl), m_last(other.m_last), m_slot(other.m_slot)
+        {
+        }
+
+
+    public:
+        constexpr auto operator*()  const -> reference { return reference(this->m_slot->first(), this->m_slot->second()); }
+        constexpr auto operator->() const -> pointer   { return pointer(**this); }
+
+        constexpr auto operator++() -> basic_iterator&
+        {
+            ++this->m_ctrl;
+            ++this->m_slot;
+            this->skip_empty();
+            return *this;
+        }
+
+        constexpr auto operator++(int) -> basic_iterator { auto tmp = *this; ++*this; return tmp; }
+
+        friend constexpr auto operator==(const basic_iterator& lhs, const basic_iterator& rhs) -> bool
+        {
+            return lhs.m_ctrl == rhs.m_ctrl;
+        }
+
+    private:
+        constexpr void skip_empty() noexcept
+        {
+            while (this->m_ctrl != this->m_last and not detail::is_full(*this->m_ctrl))
+            {
+                ++this->m_ctrl;
+                ++this->m_slot;
+            }
+        }
+
+    private:
+        template <bool> friend class basic_iterator;
+        friend class compressed_flat_map;
+
+        const detail::ctrl_t* m_ctrl = nullptr;
+        const detail::ctrl_t* m_last = nullptr;
+        slot_pointer m_slot = nullptr;
+    };
+
+    using iterator       = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+
+public:
+    compressed_flat_map() noexcept(
+        std::conjunction<std::is_nothrow_default_constructible<Hash>,
+                         std::is_nothrow_default_constructible<KeyEqual>>::value) = default;
+
+    explicit compressed_flat_map(size_type capacity, const Hash& hash = Hash(),
+                                 const KeyEqual& equal = KeyEqual())
+        : m_policies_and_ctrl(policies_type(hash, equal), nullptr)
+    {
+        this->reserve(capacity);
+    }
+
+    compressed_flat_map(const compressed_flat_map& other)
+        : m_policies_and_ctrl(other.m_policies_and_ctrl.first(), nullptr)
+    {
+        this->reserve(other.size());
+        for (const auto& [key, value] : other) this->try_emplace(key, value);
+    }
+
+    compressed_flat_map(compressed_flat_map&& other) noexcept(
+        std::conjunction<std::is_nothrow_move_constructible<Hash>,
+                         std::is_nothrow_move_constructible<KeyEqual>>::value)
+        : m_policies_and_ctrl(std::move(other.m_policies_and_ctrl.first()),
+                              std::exchange(other.m_policies_and_ctrl.second(), nullptr))
+        , m_size(std::exchange(other.m_size, 0))
+        , m_capacity(std::exchange(other.m_capacity, 0))
+    {
+    }
+
+    ~compressed_flat_map()
+    {
+        this->destroy_slots();
+        this->deallocate(this->ctrl(), this->m_capacity);
+    }
+
+    auto operator=(const compressed_flat_map& rhs) -> compressed_flat_map&
+    {
+        if (this != &rhs) compressed_flat_map(rhs).swap(*this);
+        return *this;
+    }
+
+    auto operator=(compressed_flat_map&& rhs) noexcept -> compressed_flat_map&
+    {
+        compressed_flat_map(std::move(rhs)).swap(*this);
+        return *this;
+    }
+
+
+public:
+    auto begin() noexcept -> iterator
+    {
+        return iterator(this->ctrl(), this->ctrl() + this->m_capacity, this->slots());
+    }
+
+    auto begin() const noexcept -> const_iterator
+    {
+        return const_iterator(this->ctrl(), this->ctrl() + this->m_capacity, this->slots());
+    }
+
+    auto end() noexcept -> iterator
+    {
+        return iterator(this->ctrl() + this->m_capacity, this->ctrl() + this->m_capacity, nullptr);
+    }
+
+    auto end() const noexcept -> const_iterator
+    {
+        return const_iterator(this->ctrl() + this->m_capacity, this->ctrl() + this->m_capacity, nullptr);
+    }
+
+
+public:
+    auto size()     const noexcept -> size_type { return this->m_size; }
+    auto capacity() const noexcept -> size_type { return this->m_capacity; }
+    auto empty()    const noexcept -> bool      { return this->m_size == 0; }
+
+    auto hash_function() const -> hasher    { return this->m_policies_and_ctrl.first().first(); }
+    auto key_eq()        const -> key_equal { return this->m_policies_and_ctrl.first().second(); }
+
+
+public:
+    auto find(const Key& key) -> iterator
+    {
+        const auto index = this->find_index(key);
+        return index == npos ? this->end() : this->iterator_at(index);
+    }
+
+    auto find(const Key& key) const -> const_iterator
+    {
+        const auto index = this->find_index(key);
+        return index == npos ? this->end() : this->iterator_at(index);
+    }
+
+    auto contains(const Key& key) const -> bool { return this->find_index(key) != npos; }
+
+    auto count(const Key& key) const -> size_type { return this->contains(key) ? 1 : 0; }
+
+
+public:
+    // Inserts the element constructed in place from std::forward<K>(key) and
+    // std::forward<ARGS>(args)... if the key isn't in the map yet.
+    template <typename K, typename... ARGS>
+    auto try_emplace(K&& key, ARGS&&... args) -> std::pair<iterator, bool>
+        requires(std::conjunction<std::is_constructible<Key, K>,
+                                  std::is_constructible<Value, ARGS...>>::value)
+    {
+        const auto [index, inserted] = this->find_or_insert(key, [&](value_type* slot) {
+            std::construct_at(slot, std::piecewise_construct,
+                              std::forward_as_tuple(std::forward<K>(key)),
+                              std::forward_as_tuple(std::forward<ARGS>(args)...));
+        });
+
+        return {this->iterator_at(index), inserted};
+    }
+
+    auto insert(const value_type& value) -> std::pair<iterator, bool>
+    {
+        return this->try_emplace(value.first(), value.second());
+    }
+
+    auto insert(value_type&& value) -> std::pair<iterator, bool>
+    {
+        return this->try_emplace(std::move(value.first()), std::move(value.second()));
+    }
+
+    auto operator[](const Key& key) -> Value&
+        requires(std::is_default_constructible<Value>::value)
+    {
+        return this->try_emplace(key).first->second();
+    }
+
+
+public:
+    auto erase(const Key& key) -> size_type
+    {
+        const auto index = this->find_index(key);
+        if (index == npos) return 0;
+
+        this->erase_at(index);
+        return 1;
+    }
+
+    void erase(const_iterator position)
+    {
+        this->erase_at(static_cast<size_type>(position.m_ctrl - this->ctrl()));
+    }
+
+    // destroys all the elements, the capacity is unchanged
+    void clear() noexcept
+    {
+        this->destroy_slots();
+        this->m_size = 0;
+
+        if (this->m_capacity != 0) this->reset_ctrl();
+    }
+
+    // grows the table to hold at least count elements without rehashing
+    void reserve(size_type count)
+    {
+        if (count <= this->growth_capacity()) return;
+
+        size_type capacity = detail::probe_group::width;
+        while (capacity - capacity / 8 < count) capacity *= 2;
+
+        this->resize(capacity, [] { return npos; });
+    }
+
+
+public:
+    void swap(compressed_flat_map& other) noexcept(
+        std::conjunction<std::is_nothrow_swappable<Hash>,
+                         std::is_nothrow_swappable<KeyEqual>>::value)
+    {
+        using std::swap;
+        swap(this->m_policies_and_ctrl, other.m_policies_and_ctrl);
+        swap(this->m_size, other.m_size);
+        swap(this->m_capacity, other.m_capacity);
+    }
+
+
+private:
+    using ctrl_t        = detail::ctrl_t;
+    using probe_group   = detail::probe_group;
+    using policies_type = compressed_pair<Hash, KeyEqual>;
+
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
+    // the allocation holds the number of elements which can still be inserted
+    // before growing, the control bytes ( followed by a copy of the first
+    // group, so that a group can be loaded at any position ) and the slots
+    static constexpr size_type alignment =
+        alignof(value_type) > alignof(size_type) ? alignof(value_type) : alignof(size_type);
+
+    static constexpr auto ctrl_offset() noexcept -> size_type { return sizeof(size_type); }
+
+    static constexpr auto slots_offset(size_type capacity) noexcept -> size_type
+    {
+        const size_type end_of_ctrl = ctrl_offset() + capacity + probe_group::width;
+        return (end_of_ctrl + alignof(value_type) - 1) / alignof(value_type) * alignof(value_type);
+    }
+
+    static constexpr auto allocation_size(size_type capacity) noexcept -> size_type
+    {
+        return slots_offset(capacity) + capacity * sizeof(value_type);
+    }
+
+
+private:
+    auto ctrl() const noexcept -> ctrl_t* { return this->m_policies_and_ctrl.second(); }
+
+    auto slots() const noexcept -> value_type*
+    {
+        if (this->m_capacity == 0) return nullptr;
+
+        auto base = reinterpret_cast<std::byte*>(this->ctrl()) - ctrl_offset();
+        return std::launder(reinterpret_cast<value_type*>(base + slots_offset(this->m_capacity)));
+    }
+
+    auto growth_left() const noexcept -> size_type&
+    {
+        return *std::launder(reinterpret_cast<size_type*>(
+            reinterpret_cast<std::byte*>(this->ctrl()) - ctrl_offset()));
+    }
+
+    // maximum number of elements before growing, the load factor is 7/8
+    auto growth_capacity() const noexcept -> size_type
+    {
+        return this->m_capacity - this->m_capacity / 8;
+    }
+
+    auto hash_of(const Key& key) const -> size_type
+    {
+        // std::hash is the identity for integers, h1 and h2 need all the bits mixed
+        return detail::hash_mix(this->m_policies_and_ctrl.first().first()(key));
+    }
+
+    auto iterator_at(size_type index) noexcept -> iterator
+    {
+        return iterator(this->ctrl() + index, this->ctrl() + this->m_capacity, this->slots() + index);
+    }
+
+    auto iterator_at(size_type index) const noexcept -> const_iterator
+    {
+        return const_iterator(this->ctrl() + index, this->ctrl() + this->m_capacity, this->slots() + index);
+    }
+
+
+private:
+    // sets the control byte of the slot index and of its copy past the end
+    void set_ctrl(size_type index, ctrl_t value) noexcept
+    {
+        const size_type mask = this->m_capacity - 1;
+
+        this->ctrl()[index] = value;
+        this->ctrl()[((index - probe_group::width) & mask) + probe_group::width] = value;
+    }
+
+    void reset_ctrl() noexcept
+    {
+        std::memset(this->ctrl(), static_cast<unsigned char>(detail::ctrl_empty),
+                    this->m_capacity + probe_group::width);
+        this->growth_left() = this->growth_capacity() - this->m_size;
+    }
+
+    // visits the groups on the quadratic probe sequence of hash until f returns
+    // true. the table always has an empty slot, so the probing always ends.
+    template <typename F>
+    void probe(size_type hash, F&& f) const
+    {
+        const size_type mask = this->m_capacity - 1;
+        size_type position = (hash >> 7) & mask;
+
+        for (size_type step = probe_group::width;; step += probe_group::width)
+        {
+            if (f(probe_group(this->ctrl() + position), position)) return;
+
+            position = (position + step) & mask;
+        }
+    }
+
+    auto find_index(const Key& key) const -> size_type
+    {
+        if (this->m_size == 0) return npos;
+
+        const auto hash = this->hash_of(key);
+        const auto h2   = static_cast<ctrl_t>(hash & 0x7f);
+        const auto mask = this->m_capacity - 1;
+        const auto& equal = this->m_policies_and_ctrl.first().second();
+
+        size_type found = npos;
+        this->probe(hash, [&](const probe_group& group, size_type position) {
+            for (auto bits = group.match(h2); bits != 0; bits &= bits - 1)
+            {
+                const auto index = (position + std::countr_zero(bits)) & mask;
+                if (equal(this->slots()[index].first(), key))
+                {
+                    found = index;
+                    return true;
+                }
+            }
+
+            // an empty slot ends the probe sequence, the key isn't in the map
+            return group.match_empty() != 0;
+        });
+
+        return found;
+    }
+
+    auto find_first_non_full(size_type hash) const noexcept -> size_type
+    {
+        const auto mask = this->m_capacity - 1;
+
+        size_type found = npos;
+        this->probe(hash, [&](const probe_group& group, size_type position) {
+            const auto bits = group.match_empty_or_deleted();
+            if (bits != 0) found = (position + std::countr_zero(bits)) & mask;
+            return bits != 0;
+        });
+
+        return found;
+    }
+
+    // returns the slot of key and false if it's already in the map, otherwise
+    // constructs the element in a slot with construct(slot) and returns true.
+    // a single probe looks the key up and finds the first empty or deleted slot
+    // of its probe sequence, where the key goes when it isn't in the map.
+    template <typename F>
+    auto find_or_insert(const Key& key, F&& construct) -> std::pair<size_type, bool>
+    {
+        const auto hash = this->hash_of(key);
+        const auto h2   = static_cast<ctrl_t>(hash & 0x7f);
+
+        size_type index = npos;
+
+        if (this->m_capacity != 0)
+        {
+            const auto mask = this->m_capacity - 1;
+            const auto& equal = this->m_policies_and_ctrl.first().second();
+
+            bool found = false;
+            this->probe(hash, [&](const probe_group& group, size_type position) {
+                for (auto bits = group.match(h2); bits != 0; bits &= bits - 1)
+                {
+                    const auto candidate = (position + std::countr_zero(bits)) & mask;
+                    if (equal(this->slots()[candidate].first(), key))
+                    {
+                        index = candidate;
+                        found = true;
+                        return true;
+                    }
+                }
+
+                if (const auto bits = group.match_empty_or_deleted(); index == npos and bits != 0)
+                {
+                    index = (position + std::countr_zero(bits)) & mask;
+                }
+
+                return group.match_empty() != 0;
+            });
+
+            if (found) return {index, false};
+        }
+
+        if (index == npos or (this->growth_left() == 0 and this->ctrl()[index] != detail::ctrl_deleted))
+        {
+            // the element is constructed in the new table before the others are
+            // moved into it, key and the arguments may refer to elements of the map
+            index = npos;
+            this->resize(this->grown_capacity(), [&] {
+                index = this->find_first_non_full(hash);
+                construct(this->slots() + index);
+                this->set_ctrl(index, h2);
+                --this->growth_left();
+                return index;
+            });
+        }
+        else
+        {
+            construct(this->slots() + index);
+            this->growth_left() -= this->ctrl()[index] == detail::ctrl_empty ? 1 : 0;
+            this->set_ctrl(index, h2);
+        }
+
+        ++this->m_size;
+
+        return {index, true};
+    }
+
+    void erase_at(size_type index) noexcept
+    {
+        std::destroy_at(this->slots() + index);
+        --this->m_size;
+
+        // the slot can be marked empty again if no probe sequence ever went past
+        // it, i.e. the groups before and after it have never been all full
+        const auto mask   = this->m_capacity - 1;
+        const auto before = probe_group(this->ctrl() + ((index - probe_group::width) & mask)).match_empty();
+        const auto after  = probe_group(this->ctrl() + index).match_empty();
+
+        const bool was_never_full = before != 0 and after != 0 and
+            static_cast<size_type>(std::countr_zero(after) + std::countl_zero(before)) < probe_group::width;
+
+        this->set_ctrl(index, was_never_full ? detail::ctrl_empty : detail::ctrl_deleted);
+        this->growth_left() += was_never_full ? 1 : 0;
+    }
+
+    // capacity of the table when it's full, the tombstones are dropped without
+    // growing if they take most of the table
+    auto grown_capacity() const noexcept -> size_type
+    {
+        if (this->m_capacity == 0) return probe_group::width;
+        if (this->m_size <= this->m_capacity * 25 / 32) return this->m_capacity;
+        return this->m_capacity * 2;
+    }
+
+    // moves all the elements into a new table of capacity slots, after
+    // before_relocation() has been called on the new table ( it returns the
+    // slot of the element it has constructed, or npos ).
+    //
+    // the elements are moved if their move constructor doesn't throw, copied
+    // otherwise, and the old ones are only destroyed once they are all in the
+    // new table: if an exception is thrown, the new table is destroyed and the
+    // map is unchanged ( the moved-from elements are left in a valid state if
+    // the hash function throws ).
+    template <typename F>
+    void resize(size_type capacity, F&& before_relocation)
+    {
+        const auto old_ctrl     = this->ctrl();
+        const auto old_slots    = this->slots();
+        const auto old_capacity = this->m_capacity;
+
+        auto base = static_cast<std::byte*>(
+            ::operator new(allocation_size(capacity), std::align_val_t{alignment}));
+
+        this->m_policies_and_ctrl.second() = reinterpret_cast<ctrl_t*>(base + ctrl_offset());
+        this->m_capacity = capacity;
+        ::new (static_cast<void*>(base)) size_type(0);
+        this->reset_ctrl();
+
+        const auto new_slots = this->slots();
+        size_type inserted = npos;
+
+        try
+        {
+            inserted = before_relocation();
+
+            for (size_type i = 0; i != old_capacity; ++i)
+            {
+                if (not detail::is_full(old_ctrl[i])) continue;
+
+                const auto hash  = this->hash_of(old_slots[i].first());
+                const auto index = this->find_first_non_full(hash);
+
+                if constexpr (is_trivially_relocatable_v<value_type>)
+                {
+                    std::memcpy(static_cast<void*>(new_slots + index), old_slots + i, sizeof(value_type));
+                }
+                else
+                {
+                    std::construct_at(new_slots + index, std::move_if_noexcept(old_slots[i]));
+                }
+
+                this->set_ctrl(index, static_cast<ctrl_t>(hash & 0x7f));
+            }
+        }
+        catch (...)
+        {
+            // the bitwise copies of the old elements aren't destroyed
+            if constexpr (is_trivially_relocatable_v<value_type>)
+            {
+                if (inserted != npos) std::destroy_at(new_slots + inserted);
+            }
+            else
+            {
+                this->destroy_slots();
+            }
+
+            this->deallocate(this->ctrl(), this->m_capacity);
+            this->m_policies_and_ctrl.second() = old_ctrl;
+            this->m_capacity = old_capacity;
+            throw;
+        }
+
+        if constexpr (not is_trivially_relocatable_v<value_type> and
+                      not std::is_trivially_destructible<value_type>::value)
+        {
+            for (size_type i = 0; i != old_capacity; ++i)
+            {
+                if (detail::is_full(old_ctrl[i])) std::destroy_at(old_slots + i);
+            }
+        }
+
+        this->deallocate(old_ctrl, old_capacity);
+    }
+
+    void destroy_slots() noexcept
+    {
+        if constexpr (not std::is_trivially_destructible<value_type>::value)
+        {
+            for (size_type i = 0; i != this->m_capacity; ++i)
+            {
+                if (detail::is_full(this->ctrl()[i])) std::destroy_at(this->slots() + i);
+            }
+        }
+    }
+
+    static void deallocate(ctrl_t* ctrl, size_type capacity) noexcept
+    {
+        if (capacity == 0) return;
+
+        ::operator delete(reinterpret_cast<std::byte*>(ctrl) - ctrl_offset(),
+                          std::align_val_t{alignment});
+    }
+
+
+private:
+    compressed_pair<policies_type, ctrl_t*> m_policies_and_ctrl;
+    size_type m_size     = 0;
+    size_type m_capacity = 0;  // 0 or a power of two >= probe_group::width
+};
+#endif
@@ -9,6 +9,10 @@
 #ifndef __COMPRESSED_PAIR_HXX__
 #define __COMPRESSED_PAIR_HXX__
 
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <memory>
 #include <tuple>
 #include <type_traits>
 
@@ -47,6 +51,92 @@ template <template <typename...> class Trait, typename T, typename... U>
 struct unpack_tuple<Trait, T, const std::tuple<U...>&>
     : public Trait<T, const U&...> {};
 
+
+// f() can initialize a T, in place ( guaranteed copy elision ) when it
+// returns a T prvalue, so that T doesn't have to be movable
+template <typename F, typename T>
+concept factory_for =
+    std::is_invocable<F>::value and
+    (std::is_same<std::invoke_result_t<F>, typename std::remove_cv<T>::type>::value or
+     std::is_constructible<T, std::invoke_result_t<F>>::value);
+
+template <typename F, typename T>
+struct is_nothrow_factory_for
+    : public std::conjunction<
+          std::is_nothrow_invocable<F>,
+          std::disjunction<std::is_same<std::invoke_result_t<F>, typename std::remove_cv<T>::type>,
+                           std::is_nothrow_constructible<T, std::invoke_result_t<F>>>> {};
+
+// f() can initialize a T base class subobject, a T prvalue is moved into it
+template <typename F, typename T>
+concept base_factory_for =
+    std::is_invocable<F>::value and std::is_constructible<T, std::invoke_result_t<F>>::value;
+
+template <typename F, typename T>
+struct is_nothrow_base_factory_for
+    : public std::conjunction<std::is_nothrow_invocable<F>,
+                              std::is_nothrow_constructible<T, std::invoke_result_t<F>>> {};
+
+
+// a member can be stored as a base class ( "empty base-class optimization" )
+// if and only if it's an empty class which is not marked final
+template <typename T>
+struct is_ebo_candidate
+    : public std::bool_constant<std::is_empty_v<T> and not std::is_final_v<T>> {};
+
+
+// avalanching mix of a hash value ( boost::hash_mix ), so that all the bits of
+// the result depend on all the bits of the input
+constexpr auto hash_mix(std::size_t x) noexcept -> std::size_t
+{
+    if constexpr (sizeof(std::size_t) >= 8)
+    {
+        constexpr std::size_t m = 0xe9846af9b1a615d;
+
+        x ^= x >> 32; x *= m;
+        x ^= x >> 32; x *= m;
+        x ^= x >> 28;
+    }
+    else
+    {
+        x ^= x >> 16; x *= 0x21f0aaad;
+        x ^= x >> 15; x *= 0x735a2d97;
+        x ^= x >> 15;
+    }
+
+    return x;
+}
+
+constexpr auto hash_combine(std::size_t seed, std::size_t value) noexcept -> std::size_t
+{
+    return hash_mix(seed + 0x9e3779b9 + value);
+}
+
+// an empty member has no state, it doesn't take part in the hash
+template <typename T>
+concept hashable_member =
+    std::is_empty<T>::value or
+    requires(const T& value) {
+        { std::hash<typename std::remove_cv<T>::type>{}(value) } -> std::convertible_to<std::size_t>;
+    };
+
+// the members of two pairs compare with each other. only the operators used by
+// the comparisons of compressed_pair are required, std::equality_comparable_with
+// and std::totally_ordered_with cost a common reference and every operator for
+// every pair type compared.
+template <typename T, typename U>
+concept equality_comparable_member =
+    requires(const std::remove_reference_t<T>& lhs, const std::remove_reference_t<U>& rhs) {
+        { lhs == rhs } -> std::convertible_to<bool>;
+    };
+
+template <typename T, typename U>
+concept less_than_comparable_member =
+    requires(const std::remove_reference_t<T>& lhs, const std::remove_reference_t<U>& rhs) {
+        { lhs < rhs } -> std::convertible_to<bool>;
+        { rhs < lhs } -> std::convertible_to<bool>;
+    };
+
 }  // namespace detail
 
 /** END **/
@@ -111,37 +201,34 @@ public:
     {
     }
 
-    // Forwards the elements of tuple1 to the constructor of m_first
-    // and forwards the elements of tuple2 to the constructor of m_second.
-    template <template <typename...> class Tuple1, typename... Ts1,
-              template <typename...> class Tuple2, typename... Ts2>
-    constexpr compressed_pair_impl( std::piecewise_construct_t, const Tuple1<Ts1...>& tuple1, const Tuple2<Ts2...>& tuple2)
-        noexcept(std::conjunction<std::is_nothrow_constructible<T1, Ts1...>,
-                                  std::is_nothrow_constructible<T2, Ts2...>>::value)
-        requires(std::conjunction<
-                    detail::is_specialization_of<Tuple1<Ts1...>, std::tuple>,
-                    detail::is_specialization_of<Tuple2<Ts2...>, std::tuple>,
-                    std::is_constructible<T1, Ts1...>,
-                    std::is_constructible<T2, Ts2...>>::value)
-        : m_first(std::make_from_tuple<first_type>(tuple1))
-        , m_second(std::make_from_tuple<second_type>(tuple2))
-    {
-    }
-
-    //    template <typename Tuple1, typename Tuple2>
-    //    constexpr compressed_pair_impl( std::piecewise_construct_t, Tuple1&& tuple1, Tuple2&& tuple2)
-    //        noexcept(std::conjunction<
-    //                             unpack_tuple<std::is_nothrow_constructible,T1, Tuple1>,
-    //                             unpack_tuple<std::is_nothrow_constructible,T2, Tuple2>>::value)
-    //        requires(std::conjunction<
-    //                 detail::is_specialization_of<Tuple1, std::tuple>,
-    //                 detail::is_specialization_of<Tuple2, std::tuple>,
-    //                 unpack_tuple<std::is_constructible, T1, Tuple1>,
-    //                 unpack_tuple<std::is_constructible, T2, Tuple2>>::value)
-    //        : m_first( std::make_from_tuple<first_type>(tuple1) )
-    //         , m_second( std::make_from_tuple<second_type>(tuple2) )
-    //    {
-    //    }
+    // Forwards the elements of tuple1 to the constructor of first
+    // and forwards the elements of tuple2 to the constructor of second.
+    template <typename Tuple1, typename Tuple2>
+    constexpr compressed_pair_impl(std::piecewise_construct_t, Tuple1&& tuple1, Tuple2&& tuple2)
+        noexcept(std::conjunction<
+                    detail::unpack_tuple<std::is_nothrow_constructible, T1, Tuple1>,
+                    detail::unpack_tuple<std::is_nothrow_constructible, T2, Tuple2>>::value)
+        requires(detail::specialization_of<Tuple1, std::tuple> and
+                 detail::specialization_of<Tuple2, std::tuple>) &&
+                (std::conjunction<
+                    detail::unpack_tuple<std::is_constructible, T1, Tuple1>,
+                    detail::unpack_tuple<std::is_constructible, T2, Tuple2>>::value)
+        : m_first(std::make_from_tuple<first_type>(std::forward<Tuple1>(tuple1)))
+        , m_second(std::make_from_tuple<second_type>(std::forward<Tuple2>(tuple2)))
+    {
+    }
+
+    // Initializes first with std::forward<F1>(f1)() and second with std::forward<F2>(f2)().
+    // a member is constructed in place when its factory returns it by value.
+    template <typename F1, typename F2>
+    constexpr compressed_pair_impl(std::in_place_t, F1&& f1, F2&& f2)
+        noexcept(std::conjunction<detail::is_nothrow_factory_for<F1, T1>,
+                                  detail::is_nothrow_factory_for<F2, T2>>::value)
+        requires(detail::factory_for<F1, T1> and detail::factory_for<F2, T2>)
+        : m_first(std::forward<F1>(f1)())
+        , m_second(std::forward<F2>(f2)())
+    {
+    }
 
 
 public:
@@ -149,15 +236,15 @@ public:
     constexpr auto first() const& -> const first_type&  { return this->m_first; }
     constexpr auto first()      & ->       first_type&  { return this->m_first; }
 
-    constexpr auto first() const&& -> const first_type&& { return std::move(this->m_first); }
-    constexpr auto first()      && ->       first_type&& { return std::move(this->m_first); }
+    constexpr auto first() const&& -> const first_type&& { return std::forward<const first_type>(this->m_first); }
+    constexpr auto first()      && ->       first_type&& { return std::forward<first_type>(this->m_first); }
 
     // access second element of a pair
     constexpr auto second() const& -> const second_type& { return this->m_second; }
     constexpr auto second()      & ->       second_type& { return this->m_second; }
     
-    constexpr auto second() const&& -> const second_type&& { return std::move(this->m_second); }
-    constexpr auto second()      && ->       second_type&& { return std::move(this->m_second); }
+    constexpr auto second() const&& -> const second_type&& { return std::forward<const second_type>(this->m_second); }
+    constexpr auto second()      && ->       second_type&& { return std::forward<second_type>(this->m_second); }
 
 
 public:
@@ -237,32 +324,54 @@ public:
     {
     }
 
-    // Forwards the elements of tuple to the constructor of m_second
-    template <template <typename...> class Tuple, typename... ARGS>
-    constexpr compressed_pair_impl(std::piecewise_construct_t,const Tuple<ARGS...>& tuple)
-        noexcept(std::conjunction<std::is_nothrow_default_constructible<T1>,
-                                  std::is_nothrow_constructible< T2, ARGS...>>::value)
-        requires(std::conjunction<
-                    detail::is_specialization_of<Tuple<ARGS...>, std::tuple>,
-                    std::is_default_constructible<T1>,
-                    std::is_constructible<T2, ARGS...>>::value)
-        : T1(), m_second(std::make_from_tuple<second_type>(tuple)) 
+    // Forwards the elements of tuple1 to the constructor of first
+    // and forwards the elements of tuple2 to the constructor of second.
+    template <typename Tuple1, typename Tuple2>
+    constexpr compressed_pair_impl(std::piecewise_construct_t, Tuple1&& tuple1, Tuple2&& tuple2)
+        noexcept(std::conjunction<
+                    detail::unpack_tuple<std::is_nothrow_constructible, T1, Tuple1>,
+                    detail::unpack_tuple<std::is_nothrow_constructible, T2, Tuple2>>::value)
+        requires(detail::specialization_of<Tuple1, std::tuple> and
+                 detail::specialization_of<Tuple2, std::tuple>) &&
+                (std::conjunction<
+                    detail::unpack_tuple<std::is_constructible, T1, Tuple1>,
+                    detail::unpack_tuple<std::is_constructible, T2, Tuple2>>::value)
+        : compressed_pair_impl(std::piecewise_construct, std::forward<Tuple1>(tuple1), std::forward<Tuple2>(tuple2),
+                               std::make_index_sequence<std::tuple_size_v<std::remove_cvref_t<Tuple1>>>())
+    {
+    }
+
+    // Initializes first with std::forward<F1>(f1)() and second with std::forward<F2>(f2)().
+    // the member m_second is constructed in place when its factory returns it by value,
+    // the result of the factory of the base class is moved into it ( the copy
+    // elision isn't guaranteed for base class subobjects, a non-movable empty
+    // member has to be constructed piecewise ).
+    template <typename F1, typename F2>
+    constexpr compressed_pair_impl(std::in_place_t, F1&& f1, F2&& f2)
+        noexcept(std::conjunction<detail::is_nothrow_base_factory_for<F1, T1>,
+                                  detail::is_nothrow_factory_for<F2, T2>>::value)
+        requires(detail::base_factory_for<F1, T1> and detail::factory_for<F2, T2>)
+        : T1(std::forward<F1>(f1)())
+        , m_second(std::forward<F2>(f2)())
     {
     }
 
 
 public:
     // access first element of a pair
-    constexpr auto first() const -> const first_type& { return *this; }
-    constexpr auto first()       ->       first_type& { return *this; }
-    
-    
+    constexpr auto first() const& -> const first_type& { return *this; }
+    constexpr auto first()      & ->       first_type& { return *this; }
+
+    constexpr auto first() const&& -> const first_type&& { return std::move(static_cast<const first_type&>(*this)); }
+    constexpr auto first()      && ->       first_type&& { return std::move(static_cast<first_type&>(*this)); }
+
+
     // access second element of a pair
     constexpr auto second() const& -> const second_type& { return this->m_second; }
     constexpr auto second()      & ->       second_type& { return this->m_second; }
     
-    constexpr auto second() const&& -> const second_type&& { return std::move(this->m_second); } 
-    constexpr auto second()      && ->       second_type&& { return std::move(this->m_second); } 
+    constexpr auto second() const&& -> const second_type&& { return std::forward<const second_type>(this->m_second); }
+    constexpr auto second()      && ->       second_type&& { return std::forward<second_type>(this->m_second); }
     
 public:
     void swap(compressed_pair_impl& other) noexcept(
@@ -273,6 +382,18 @@ public:
         swap(this->m_second, other.second());
     }
 
+private:
+    // constructs the base class directly from the elements of the tuple: a base
+    // class initialized from the prvalue of std::make_from_tuple is moved, the
+    // copy elision isn't guaranteed for base class subobjects
+    template <typename Tuple1, typename Tuple2, std::size_t... I1>
+    constexpr compressed_pair_impl(std::piecewise_construct_t, [[maybe_unused]] Tuple1&& tuple1, Tuple2&& tuple2,
+                                   std::index_sequence<I1...>)
+        : T1(std::get<I1>(std::forward<Tuple1>(tuple1))...)
+        , m_second(std::make_from_tuple<second_type>(std::forward<Tuple2>(tuple2)))
+    {
+    }
+
 private:
     T2 m_second;
 
@@ -332,21 +453,40 @@ public:
                          std::is_nothrow_constructible<T2, U2>>::value)
         requires(std::conjunction<std::is_constructible<T1, U1>,
                                   std::is_constructible<T2, U2>>::value)
-        : T2(std::forward_like<U2>(second))
-        , m_first(std::forward_like<U1>(first))
+        : T2(std::forward<U2>(second))
+        , m_first(std::forward<U1>(first))
     {
     }
 
-    // Forwards the elements of tuple1 to the constructor of m_first
-    template <template <typename...> class Tuple, typename... ARGS>
-    constexpr compressed_pair_impl( std::piecewise_construct_t, const Tuple<ARGS...>& tuple)
-        noexcept(std::conjunction<std::is_nothrow_constructible<T1, ARGS...>,
-                                  std::is_nothrow_default_constructible<T2>>::value)
-        requires(std::conjunction<
-                    detail::is_specialization_of<Tuple<ARGS...>, std::tuple>,
-                    std::is_constructible<T1, ARGS...>,
-                    std::is_default_constructible<T2>>::value)
-        : T2(), m_first(std::make_from_tuple<first_type>(tuple))
+    // Forwards the elements of tuple1 to the constructor of first
+    // and forwards the elements of tuple2 to the constructor of second.
+    template <typename Tuple1, typename Tuple2>
+    constexpr compressed_pair_impl(std::piecewise_construct_t, Tuple1&& tuple1, Tuple2&& tuple2)
+        noexcept(std::conjunction<
+                    detail::unpack_tuple<std::is_nothrow_constructible, T1, Tuple1>,
+                    detail::unpack_tuple<std::is_nothrow_constructible, T2, Tuple2>>::value)
+        requires(detail::specialization_of<Tuple1, std::tuple> and
+                 detail::specialization_of<Tuple2, std::tuple>) &&
+                (std::conjunction<
+                    detail::unpack_tuple<std::is_constructible, T1, Tuple1>,
+                    detail::unpack_tuple<std::is_constructible, T2, Tuple2>>::value)
+        : compressed_pair_impl(std::piecewise_construct, std::forward<Tuple1>(tuple1), std::forward<Tuple2>(tuple2),
+                               std::make_index_sequence<std::tuple_size_v<std::remove_cvref_t<Tuple2>>>())
+    {
+    }
+
+    // Initializes first with std::forward<F1>(f1)() and second with std::forward<F2>(f2)().
+    // the member m_first is constructed in place when its factory returns it by value,
+    // the result of the factory of the base class is moved into it ( the copy
+    // elision isn't guaranteed for base class subobjects, a non-movable empty
+    // member has to be constructed piecewise ).
+    template <typename F1, typename F2>
+    constexpr compressed_pair_impl(std::in_place_t, F1&& f1, F2&& f2)
+        noexcept(std::conjunction<detail::is_nothrow_factory_for<F1, T1>,
+                                  detail::is_nothrow_base_factory_for<F2, T2>>::value)
+        requires(detail::factory_for<F1, T1> and detail::base_factory_for<F2, T2>)
+        : T2(std::forward<F2>(f2)())
+        , m_first(std::forward<F1>(f1)())
     {
     }
 
@@ -356,12 +496,15 @@ public:
     constexpr auto first() const& -> const first_type& { return this->m_first; }
     constexpr auto first()      & ->       first_type& { return this->m_first; }
 
-    constexpr auto first() const&& -> const first_type&& { return std::move(this->m_first); }
-    constexpr auto first()      && ->       first_type&& { return std::move(this->m_first); }
+    constexpr auto first() const&& -> const first_type&& { return std::forward<const first_type>(this->m_first); }
+    constexpr auto first()      && ->       first_type&& { return std::forward<first_type>(this->m_first); }
 
     // access second element of a pair
-    constexpr auto second() const -> const second_type& { return *this; }
-    constexpr auto second()       ->       second_type& { return *this; }    
+    constexpr auto second() const& -> const second_type& { return *this; }
+    constexpr auto second()      & ->       second_type& { return *this; }
+
+    constexpr auto second() const&& -> const second_type&& { return std::move(static_cast<const second_type&>(*this)); }
+    constexpr auto second()      && ->       second_type&& { return std::move(static_cast<second_type&>(*this)); }
 
 
 public:
@@ -373,6 +516,18 @@ public:
         swap(this->m_first, other.first());
     }
 
+private:
+    // constructs the base class directly from the elements of the tuple: a base
+    // class initialized from the prvalue of std::make_from_tuple is moved, the
+    // copy elision isn't guaranteed for base class subobjects
+    template <typename Tuple1, typename Tuple2, std::size_t... I2>
+    constexpr compressed_pair_impl(std::piecewise_construct_t, Tuple1&& tuple1, [[maybe_unused]] Tuple2&& tuple2,
+                                   std::index_sequence<I2...>)
+        : T2(std::get<I2>(std::forward<Tuple2>(tuple2))...)
+        , m_first(std::make_from_tuple<first_type>(std::forward<Tuple1>(tuple1)))
+    {
+    }
+
 private:
     T1 m_first;
 
@@ -422,21 +577,59 @@ public:
                          std::is_nothrow_constructible<T2, U2>>::value)
         requires(std::conjunction<std::is_constructible<T1, U1>,
                                   std::is_constructible<T2, U2>>::value)
-        : T1(std::forward_like<U1>(first))
-        , T2(std::forward_like<U2>(second)) 
+        : T1(std::forward<U1>(first))
+        , T2(std::forward<U2>(second))
+    {
+    }
+
+    // Forwards the elements of tuple1 to the constructor of first
+    // and forwards the elements of tuple2 to the constructor of second.
+    template <typename Tuple1, typename Tuple2>
+    constexpr compressed_pair_impl(std::piecewise_construct_t, Tuple1&& tuple1, Tuple2&& tuple2)
+        noexcept(std::conjunction<
+                    detail::unpack_tuple<std::is_nothrow_constructible, T1, Tuple1>,
+                    detail::unpack_tuple<std::is_nothrow_constructible, T2, Tuple2>>::value)
+        requires(detail::specialization_of<Tuple1, std::tuple> and
+                 detail::specialization_of<Tuple2, std::tuple>) &&
+                (std::conjunction<
+                    detail::unpack_tuple<std::is_constructible, T1, Tuple1>,
+                    detail::unpack_tuple<std::is_constructible, T2, Tuple2>>::value)
+        : compressed_pair_impl(std::piecewise_construct, std::forward<Tuple1>(tuple1), std::forward<Tuple2>(tuple2),
+                               std::make_index_sequence<std::tuple_size_v<std::remove_cvref_t<Tuple1>>>(),
+                               std::make_index_sequence<std::tuple_size_v<std::remove_cvref_t<Tuple2>>>())
+    {
+    }
+
+    // Initializes first with std::forward<F1>(f1)() and second with std::forward<F2>(f2)().
+    // the results of the factories are moved into the base classes ( the copy
+    // elision isn't guaranteed for base class subobjects, non-movable empty
+    // members have to be constructed piecewise ).
+    template <typename F1, typename F2>
+    constexpr compressed_pair_impl(std::in_place_t, F1&& f1, F2&& f2)
+        noexcept(std::conjunction<detail::is_nothrow_base_factory_for<F1, T1>,
+                                  detail::is_nothrow_base_factory_for<F2, T2>>::value)
+        requires(detail::base_factory_for<F1, T1> and detail::base_factory_for<F2, T2>)
+        : T1(std::forward<F1>(f1)())
+        , T2(std::forward<F2>(f2)())
     {
     }
 
 
 public:
     // access first element of a pair
-    constexpr auto first() const -> const first_type& { return *this; }
-    constexpr auto first()       ->       first_type& { return *this; }
+    constexpr auto first() const& -> const first_type& { return *this; }
+    constexpr auto first()      & ->       first_type& { return *this; }
+
+    constexpr auto first() const&& -> const first_type&& { return std::move(static_cast<const first_type&>(*this)); }
+    constexpr auto first()      && ->       first_type&& { return std::move(static_cast<first_type&>(*this)); }
 
 
     // access second element of a pair
-    constexpr auto second() const -> const second_type& { return *this; }
-    constexpr auto second()       ->       second_type& { return *this; }
+    constexpr auto second() const& -> const second_type& { return *this; }
+    constexpr auto second()      & ->       second_type& { return *this; }
+
+    constexpr auto second() const&& -> const second_type&& { return std::move(static_cast<const second_type&>(*this)); }
+    constexpr auto second()      && ->       second_type&& { return std::move(static_cast<second_type&>(*this)); }
 
 public:
     void swap(compressed_pair_impl& other) noexcept(
@@ -445,25 +638,63 @@ public:
     {
         return void();
     }
+
+private:
+    // constructs the base classes directly from the elements of the tuples: a
+    // base class initialized from the prvalue of std::make_from_tuple is moved,
+    // the copy elision isn't guaranteed for base class subobjects
+    template <typename Tuple1, typename Tuple2, std::size_t... I1, std::size_t... I2>
+    constexpr compressed_pair_impl(std::piecewise_construct_t, [[maybe_unused]] Tuple1&& tuple1,
+                                   [[maybe_unused]] Tuple2&& tuple2,
+                                   std::index_sequence<I1...>, std::index_sequence<I2...>)
+        : T1(std::get<I1>(std::forward<Tuple1>(tuple1))...)
+        , T2(std::get<I2>(std::forward<Tuple2>(tuple2))...)
+    {
+    }
 };
 
 
 
 
+namespace detail {
+
+// type of the members of a Pair expression, e.g. U1& for a compressed_pair<U1, U2>&
+template <typename Pair>
+using first_of = decltype(std::declval<Pair>().first());
+
+template <typename Pair>
+using second_of = decltype(std::declval<Pair>().second());
+
+// Pair is a compressed_pair of other types than Self. the copies of Self are
+// the common case, they are rejected first by a plain variable template.
+template <typename Pair, typename Self>
+concept other_compressed_pair =
+    not std::is_same_v<std::remove_cvref_t<Pair>, Self> and
+    specialization_of<std::remove_cvref_t<Pair>, compressed_pair>;
+
+// selects the compressed_pair_impl specialization for T1 and T2.
+// when T1 and T2 are the same empty type only T1 is stored as a base class,
+// a class can't inherit the same base twice.
+// ( plain variable templates, every distinct compressed_pair goes through
+// this selection and std::conjunction/std::negation would instantiate a
+// class template for each of their arguments )
+template <typename T1, typename T2,
+          bool Ebo1 = std::is_empty_v<T1> and not std::is_final_v<T1>,
+          bool Ebo2 = std::is_empty_v<T2> and not std::is_final_v<T2>>
+using compressed_pair_base = compressed_pair_impl<
+    T1, T2, Ebo1,
+    Ebo2 and not (Ebo1 and std::is_same_v<std::remove_cv_t<T1>, std::remove_cv_t<T2>>)>;
+
+}  // namespace detail
+
+
 // MAIN CLASS 
 template <typename T1, typename T2>
-class compressed_pair
-    : private compressed_pair_impl<
-          T1, T2,
-          std::conjunction<std::is_empty<T1>, std::negation<std::is_final<T1>>>::value,
-          std::conjunction<std::is_empty<T2>, std::negation<std::is_final<T2>>>::value>
+class compressed_pair : private detail::compressed_pair_base<T1, T2>
 {
 
 public:
-    using base_t = compressed_pair_impl<
-        T1, T2,
-        std::conjunction<std::is_empty<T1>, std::negation<std::is_final<T1>>>::value,
-        std::conjunction<std::is_empty<T2>, std::negation<std::is_final<T2>>>::value>;
+    using base_t = detail::compressed_pair_base<T1, T2>;
 
     using first_type  = T1;
     using second_type = T2;
@@ -472,52 +703,57 @@ public:
 public:
     using base_t::base_t;
 
-public:
-    // Copy constructor
-    constexpr compressed_pair(const compressed_pair& other) noexcept(
-        std::conjunction<std::is_nothrow_copy_constructible<T1>,
-                         std::is_nothrow_copy_constructible<T2>>::value)
-        requires(std::conjunction<std::is_copy_constructible<T1>,
-                                  std::is_copy_constructible<T2>>::value)
-        : base_t(other.first(), other.second())
+    // Copy/move constructors and assignment operators are the implicit ones,
+    // so that compressed_pair is trivially copyable whenever T1 and T2 are and
+    // containers can copy/relocate it with memmove. they are not declared
+    // explicitly: implicit special members are only declared when they are
+    // used, explicitly defaulted ones cost an overload resolution per member
+    // for every instantiation of compressed_pair.
+
+    // Converting constructor from a compressed_pair of other types, e.g. a
+    // compressed_pair<T1, T2> from the compressed_pair<T1&, T2&> proxy of a
+    // compressed_pair_vector element, or the proxy from the value.
+    // It's explicit if and only if a member isn't implicitly convertible.
+    // ( a single forwarding constructor rather than one per value category,
+    // every construction of a compressed_pair goes through its overload set )
+    template <typename Pair>
+    constexpr explicit(not std::conjunction<std::is_convertible<detail::first_of<Pair>, T1>,
+                                            std::is_convertible<detail::second_of<Pair>, T2>>::value)
+    compressed_pair(Pair&& other) noexcept(
+        std::conjunction<std::is_nothrow_constructible<T1, detail::first_of<Pair>>,
+                         std::is_nothrow_constructible<T2, detail::second_of<Pair>>>::value)
+        requires(detail::other_compressed_pair<Pair, compressed_pair>) &&
+                (std::conjunction<std::is_constructible<T1, detail::first_of<Pair>>,
+                                  std::is_constructible<T2, detail::second_of<Pair>>>::value)
+        : base_t(std::forward<Pair>(other).first(), std::forward<Pair>(other).second())
     {
     }
 
-    // Move constructor
-    constexpr compressed_pair(compressed_pair&& other) noexcept(
-        std::conjunction<std::is_nothrow_move_constructible<T1>,
-                         std::is_nothrow_move_constructible<T2>>::value)
-        requires(std::conjunction<std::is_move_constructible<T1>,
-                                  std::is_move_constructible<T2>>::value)
-        : base_t(std::move(other.first()), std::move(other.second()))
-    {
-    }
 
-    // Copy assignment operator
-    constexpr auto operator=(const compressed_pair& rhs) noexcept(
-        std::conjunction<std::is_nothrow_copy_assignable<T1>,
-                         std::is_nothrow_copy_assignable<T2>>::value)
-        -> compressed_pair&
-        requires(std::conjunction<std::is_copy_assignable<T1>,
-                                  std::is_copy_assignable<T2>>::value)
+public:
+    // Converting assignment from a compressed_pair of other types
+    template <typename Pair>
+    constexpr auto operator=(Pair&& rhs) -> compressed_pair&
+        requires(detail::specialization_of<std::remove_cvref_t<Pair>, compressed_pair>) &&
+                (std::conjunction<std::is_assignable<T1&, detail::first_of<Pair>>,
+                                  std::is_assignable<T2&, detail::second_of<Pair>>>::value)
     {
-        base_t::first() = rhs.first();
-        base_t::second() = rhs.second();
-
+        this->first()  = std::forward<Pair>(rhs).first();
+        this->second() = std::forward<Pair>(rhs).second();
         return *this;
     }
 
-    // Move assignment operator
-    constexpr auto operator=(compressed_pair&& rhs) noexcept(
-        std::conjunction<std::is_nothrow_move_assignable<T1>,
-                         std::is_nothrow_move_assignable<T2>>::value)
-        -> compressed_pair&
-        requires(std::conjunction<std::is_move_assignable<T1>,
-                                  std::is_move_assignable<T2>>::value)
+    // a pair of references assigns through the references, also when it's
+    // const: the proxy returned by a compressed_pair_vector iterator is a
+    // prvalue and *it = value must assign the element.
+    template <typename Pair>
+    constexpr auto operator=(Pair&& rhs) const -> const compressed_pair&
+        requires(detail::specialization_of<std::remove_cvref_t<Pair>, compressed_pair>) &&
+                (std::conjunction<std::is_assignable<const T1&, detail::first_of<Pair>>,
+                                  std::is_assignable<const T2&, detail::second_of<Pair>>>::value)
     {
-        base_t::first() = std::move(rhs.first());
-        base_t::second() = std::move(rhs.second());
-
+        this->first()  = std::forward<Pair>(rhs).first();
+        this->second() = std::forward<Pair>(rhs).second();
         return *this;
     }
 
@@ -525,19 +761,19 @@ public:
 public:
 
     // access first element of a pair
-    constexpr auto first() const&  noexcept -> const first_type&  { return base_t::first(); }
-    constexpr auto first()    &    noexcept ->       first_type&  { return base_t::first(); }
+    constexpr auto first() const&  noexcept -> decltype(auto) { return base_t::first(); }
+    constexpr auto first()    &    noexcept -> decltype(auto) { return base_t::first(); }
 
-    constexpr auto first() const&& noexcept -> const first_type&& { return base_t::first(); }
-    constexpr auto first()   &&    noexcept ->       first_type&& { return base_t::first(); }
+    constexpr auto first() const&& noexcept -> decltype(auto) { return static_cast<const base_t&&>(*this).first(); }
+    constexpr auto first()   &&    noexcept -> decltype(auto) { return static_cast<base_t&&>(*this).first(); }
 
 
     // access second element of a pair
-    constexpr auto second() const&  noexcept -> const second_type& { return base_t::second(); }
-    constexpr auto second()   &     noexcept ->       second_type& { return base_t::second(); }
-    
-    constexpr auto second() const&& noexcept -> const second_type&& { return base_t::second(); }
-    constexpr auto second()   &&    noexcept ->       second_type&& { return base_t::second(); }
+    constexpr auto second() const&  noexcept -> decltype(auto) { return base_t::second(); }
+    constexpr auto second()   &     noexcept -> decltype(auto) { return base_t::second(); }
+
+    constexpr auto second() const&& noexcept -> decltype(auto) { return static_cast<const base_t&&>(*this).second(); }
+    constexpr auto second()   &&    noexcept -> decltype(auto) { return static_cast<base_t&&>(*this).second(); }
 
 
 public:
@@ -553,57 +789,117 @@ public:
 
 
 
-// lexicographically compares the values in the compressed_pair ( Equality and Ordering Operators )
+// opt-in trait for containers that relocate elements with memcpy/memmove
+// (move-construct + destroy collapsed into a bitwise copy). trivially movable and
+// destructible types are relocatable by default, other types (e.g. types owning
+// a pointer to heap memory only) may opt in by specializing this trait.
+template <typename T>
+struct is_trivially_relocatable
+    : public std::conjunction<std::is_trivially_move_constructible<T>,
+                              std::is_trivially_destructible<T>> {};
+
+template <typename T1, typename T2>
+struct is_trivially_relocatable<compressed_pair<T1, T2>>
+    : public std::conjunction<is_trivially_relocatable<T1>,
+                              is_trivially_relocatable<T2>> {};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+#if defined(__GLIBCXX__) and defined(COMPRESSED_PAIR_LIBSTDCXX_RELOCATION)
+// libstdc++ relocates the elements of a std::vector with memmove when it grows
+// only for trivial types ( trivial default constructor included ). its own
+// relocation trait is a reserved internal of the library, which may change
+// with any release: specializing it is opt-in, define
+// COMPRESSED_PAIR_LIBSTDCXX_RELOCATION in every translation unit to enable it.
+namespace std {
+
+template <typename T1, typename T2>
+struct __is_bitwise_relocatable<::compressed_pair<T1, T2>, void>
+    : public bool_constant<::is_trivially_relocatable_v<::compressed_pair<T1, T2>>> {};
+
+}  // namespace std
+#endif
+
+
+
+// lexicographically compares the values in the compressed_pair ( Equality and Ordering Operators ).
+// the members may be of different types, e.g. to compare a compressed_pair<T1, T2>
+// with the compressed_pair<T1&, T2&> proxy of a compressed_pair_vector element.
 
-template <std::totally_ordered T, std::totally_ordered_with<T> U>
-constexpr auto lexicographical_compare(const compressed_pair<T, U>& lhs,
-                                       const compressed_pair<T, U>& rhs) noexcept -> bool
+template <typename T1, typename T2, typename U1, typename U2>
+constexpr auto lexicographical_compare(const compressed_pair<T1, T2>& lhs,
+                                       const compressed_pair<U1, U2>& rhs) noexcept -> bool
+    requires(detail::less_than_comparable_member<T1, U1> and detail::less_than_comparable_member<T2, U2>)
 {
-    return std::tie(lhs.first(), lhs.second()) <
-           std::tie(rhs.first(), rhs.second());
+    // compared member by member like std::pair, a std::tuple of references
+    // would instantiate the tuple comparisons for every pair
+    return lhs.first() < rhs.first() or
+           (not(rhs.first() < lhs.first()) and lhs.second() < rhs.second());
 }
 
-template <std::equality_comparable T, std::equality_comparable_with<T> U>
-constexpr auto operator==(const compressed_pair<T, U>& lhs,
-                          const compressed_pair<T, U>& rhs) noexcept -> bool
+template <typename T1, typename T2, typename U1, typename U2>
+constexpr auto operator==(const compressed_pair<T1, T2>& lhs,
+                          const compressed_pair<U1, U2>& rhs) noexcept -> bool
+    requires(detail::equality_comparable_member<T1, U1> and detail::equality_comparable_member<T2, U2>)
 {
-    return std::tie(lhs.first(), lhs.second()) ==
-           std::tie(rhs.first(), rhs.second());
+    return lhs.first() == rhs.first() and lhs.second() == rhs.second();
 }
 
-template <std::equality_comparable T, std::equality_comparable_with<T> U>
-constexpr auto operator!=(const compressed_pair<T, U>& lhs,
-                          const compressed_pair<T, U>& rhs) noexcept -> bool
+template <typename T1, typename T2, typename U1, typename U2>
+constexpr auto operator!=(const compressed_pair<T1, T2>& lhs,
+                          const compressed_pair<U1, U2>& rhs) noexcept -> bool
+    requires(detail::equality_comparable_member<T1, U1> and detail::equality_comparable_member<T2, U2>)
 {
     return not(lhs == rhs);
 }
 
-template <std::totally_ordered T, std::totally_ordered_with<T> U>
-constexpr auto operator>(const compressed_pair<T, U>& lhs,
-                         const compressed_pair<T, U>& rhs) noexcept -> bool
+template <typename T1, typename T2, typename U1, typename U2>
+constexpr auto operator>(const compressed_pair<T1, T2>& lhs,
+                         const compressed_pair<U1, U2>& rhs) noexcept -> bool
+    requires(detail::less_than_comparable_member<T1, U1> and detail::less_than_comparable_member<T2, U2>)
 {
     return lexicographical_compare(rhs, lhs);
 }
 
-template <std::totally_ordered T, std::totally_ordered_with<T> U>
-constexpr auto operator>=(const compressed_pair<T, U>& lhs,
-                          const compressed_pair<T, U>& rhs) noexcept -> bool
+template <typename T1, typename T2, typename U1, typename U2>
+constexpr auto operator>=(const compressed_pair<T1, T2>& lhs,
+                          const compressed_pair<U1, U2>& rhs) noexcept -> bool
+    requires(detail::less_than_comparable_member<T1, U1> and detail::less_than_comparable_member<T2, U2>)
 {
-    return not(lhs < rhs);
+    return not lexicographical_compare(lhs, rhs);
 }
 
-template <std::totally_ordered T, std::totally_ordered_with<T> U>
-constexpr auto operator<(const compressed_pair<T, U>& lhs,
-                         const compressed_pair<T, U>& rhs) noexcept -> bool
+template <typename T1, typename T2, typename U1, typename U2>
+constexpr auto operator<(const compressed_pair<T1, T2>& lhs,
+                         const compressed_pair<U1, U2>& rhs) noexcept -> bool
+    requires(detail::less_than_comparable_member<T1, U1> and detail::less_than_comparable_member<T2, U2>)
 {
     return lexicographical_compare(lhs, rhs);
 }
 
-template <std::totally_ordered T, std::totally_ordered_with<T> U>
-constexpr auto operator<=(const compressed_pair<T, U>& lhs,
-                          const compressed_pair<T, U>& rhs) noexcept -> bool
+template <typename T1, typename T2, typename U1, typename U2>
+constexpr auto operator<=(const compressed_pair<T1, T2>& lhs,
+                          const compressed_pair<U1, U2>& rhs) noexcept -> bool
+    requires(detail::less_than_comparable_member<T1, U1> and detail::less_than_comparable_member<T2, U2>)
 {
-    return not(rhs < lhs);
+    return not lexicographical_compare(rhs, lhs);
+}
+
+
+
+// swaps the referred values of two pairs of references, e.g. the prvalue
+// proxies of two compressed_pair_vector elements ( std::iter_swap )
+template <typename T1, typename T2>
+constexpr void swap(const compressed_pair<T1, T2>& lhs, const compressed_pair<T1, T2>& rhs) noexcept(
+    std::conjunction<std::is_nothrow_swappable<const T1>,
+                     std::is_nothrow_swappable<const T2>>::value)
+    requires(std::conjunction<std::is_reference<T1>, std::is_reference<T2>,
+                              std::is_swappable<const T1>, std::is_swappable<const T2>>::value)
+{
+    using std::swap;
+    swap(lhs.first(), rhs.first());
+    swap(lhs.second(), rhs.second());
 }
 
 
@@ -621,36 +917,79 @@ struct tuple_element<Index, ::compressed_pair<T, U>> : public tuple_element<Inde
 }  // namespace std
 
 
+// common type and common reference of two compressed_pair, member by member.
+// they make compressed_pair<T1&, T2&> and compressed_pair<T1, T2> the reference
+// and the value type of a C++20 iterator ( std::indirectly_readable ).
+namespace std {
+
+template <typename T1, typename T2, typename U1, typename U2>
+    requires requires { typename ::compressed_pair<common_type_t<T1, U1>, common_type_t<T2, U2>>; }
+struct common_type<::compressed_pair<T1, T2>, ::compressed_pair<U1, U2>>
+{
+    using type = ::compressed_pair<common_type_t<T1, U1>, common_type_t<T2, U2>>;
+};
+
+template <typename T1, typename T2, typename U1, typename U2,
+          template <typename> class TQual, template <typename> class UQual>
+    requires requires { typename ::compressed_pair<common_reference_t<TQual<T1>, UQual<U1>>,
+                                                   common_reference_t<TQual<T2>, UQual<U2>>>; }
+struct basic_common_reference<::compressed_pair<T1, T2>, ::compressed_pair<U1, U2>, TQual, UQual>
+{
+    using type = ::compressed_pair<common_reference_t<TQual<T1>, UQual<U1>>,
+                                   common_reference_t<TQual<T2>, UQual<U2>>>;
+};
+
+}  // namespace std
+
+
 template <std::size_t Index, typename T1, typename T2>
-constexpr auto get(compressed_pair<T1, T2>& my_pair) ->
-    typename std::tuple_element<Index, compressed_pair<T1, T2>>::type&
+constexpr auto get(compressed_pair<T1, T2>& my_pair) -> decltype(auto)
 {
     if constexpr (Index == 0) return my_pair.first();
     if constexpr (Index == 1) return my_pair.second();
 }
 
 template <std::size_t Index, typename T1, typename T2>
-constexpr auto get(const compressed_pair<T1, T2>& my_pair) ->
-    typename std::tuple_element<Index, compressed_pair<T1, T2>>::type const&
+constexpr auto get(const compressed_pair<T1, T2>& my_pair) -> decltype(auto)
 {
     if constexpr (Index == 0) return my_pair.first();
     if constexpr (Index == 1) return my_pair.second();
 }
 
 template <std::size_t Index, typename T1, typename T2>
-constexpr auto get(compressed_pair<T1, T2>&& my_pair) ->
-    typename std::tuple_element<Index, compressed_pair<T1, T2>>::type&&
+constexpr auto get(compressed_pair<T1, T2>&& my_pair) -> decltype(auto)
 {
-    if constexpr (Index == 0) return std::move(my_pair.first());
-    if constexpr (Index == 1) return std::move(my_pair.second());
+    if constexpr (Index == 0) return std::move(my_pair).first();
+    if constexpr (Index == 1) return std::move(my_pair).second();
 }
 
 template <std::size_t Index, typename T1, typename T2>
-constexpr auto get(const compressed_pair<T1, T2>&& my_pair) ->
-    typename std::tuple_element<Index, compressed_pair<T1, T2>>::type const&&
+constexpr auto get(const compressed_pair<T1, T2>&& my_pair) -> decltype(auto)
 {
-    if constexpr (Index == 0) return std::move(my_pair.first());
-    if constexpr (Index == 1) return std::move(my_pair.second());
+    if constexpr (Index == 0) return std::move(my_pair).first();
+    if constexpr (Index == 1) return std::move(my_pair).second();
 }
-#endif
 
+
+// hash support, the hashes of the members are combined in order
+namespace std {
+
+template <::detail::hashable_member T, ::detail::hashable_member U>
+struct hash<::compressed_pair<T, U>>
+{
+    auto operator()(const ::compressed_pair<T, U>& value) const noexcept(
+        conjunction<disjunction<is_empty<T>, is_nothrow_invocable<hash<remove_cv_t<T>>, const T&>>,
+                    disjunction<is_empty<U>, is_nothrow_invocable<hash<remove_cv_t<U>>, const U&>>>::value)
+        -> size_t
+    {
+        size_t seed = 0;
+
+        if constexpr (not is_empty<T>::value) seed = ::detail::hash_combine(seed, hash<remove_cv_t<T>>{}(value.first()));
+        if constexpr (not is_empty<U>::value) seed = ::detail::hash_combine(seed, hash<remove_cv_t<U>>{}(value.second()));
+
+        return seed;
+    }
+};
+
+}  // namespace std
+#endif
@@ -0,0 +1,461 @@
+//  ------------------------------------
+//      Copyright (C) 2018 MO ELomari
+//  ------------------------------------
+
+// The compressed pair table is a flat, versioned file format for arrays of
+// compressed_pair<T1, T2>: a header describing the layout of the elements,
+// followed by the elements themselves, byte for byte as they are in memory.
+// write_compressed_pair_table writes a table in a single pass, and
+// mapped_compressed_pair_table maps it back read-only ( POSIX mmap ) as a span
+// of compressed_pair without copying or parsing anything; the pages are only
+// read from the disk when they are first accessed.
+//
+// the header records the byte order, the size and alignment of the elements
+// and the offset, size and kind ( integral, floating point, signed, ... ) of
+// each member, a table written by a build with a different layout or other
+// member types is rejected when it is opened. members of class type are told
+// apart by their compressed_pair_table_schema tag. empty members are
+// compressed away by compressed_pair and don't take any byte on disk either.
+//
+// a table is written to a temporary file which replaces the previous one
+// once it is complete, the processes mapping the previous table keep reading
+// it ( the file isn't truncated under them ).
+//
+// the elements must be trivially copyable and must not contain pointers, the
+// values are only meaningful for the process that wrote them.
+
+#ifndef __COMPRESSED_PAIR_TABLE_HXX__
+#define __COMPRESSED_PAIR_TABLE_HXX__
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "compressed_pair.hxx"
+
+
+// first bytes of a header, and current version of the format
+inline constexpr std::array<char, 8> compressed_pair_table_magic = {'C', 'P', 'T', 'A', 'B', 'L', 'E', '\0'};
+inline constexpr std::uint32_t compressed_pair_table_version = 2;
+
+
+// tag of a class type stored in a table, specialize it for the members of
+// class type, so that a table of another class of the same size is rejected, e.g.
+//
+//   template <> struct compressed_pair_table_schema<price> { static constexpr std::uint64_t tag = 0x7072696365'0001; };
+//
+// change the tag when the members of the class change.
+template <typename T>
+struct compressed_pair_table_schema
+{
+    static constexpr std::uint64_t tag = 0;
+};
+
+
+// layout of the elements of a table, as stored in its header
+struct compressed_pair_table_layout
+{
+    // written in the native byte order, reads 0x01020304 only on a machine
+    // with the same byte order
+    std::uint32_t byte_order;
+    std::uint32_t empty_members;  // bit 0: first is empty, bit 1: second is empty
+
+    std::uint64_t element_size;
+    std::uint64_t element_alignment;
+
+    std::uint64_t first_offset;
+    std::uint64_t first_size;
+    std::uint64_t second_offset;
+    std::uint64_t second_size;
+
+    // detail::member_kind flags, and compressed_pair_table_schema tag
+    std::uint32_t first_kind;
+    std::uint32_t second_kind;
+    std::uint64_t first_schema;
+    std::uint64_t second_schema;
+
+    friend constexpr auto operator==(const compressed_pair_table_layout&,
+                                     const compressed_pair_table_layout&) -> bool = default;
+};
+
+// header at the beginning of a table file, the elements start at data_offset
+struct compressed_pair_table_header
+{
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t header_size;
+
+    compressed_pair_table_layout layout;
+
+    std::uint64_t count;
+    std::uint64_t data_offset;
+};
+
+
+// thrown when a file isn't a table, or was written with another layout
+class compressed_pair_table_error : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
+
+namespace detail {
+
+template <typename T1, typename T2>
+concept mappable_pair =
+    std::is_trivially_copyable<compressed_pair<T1, T2>>::value and
+    not std::is_pointer<T1>::value and not std::is_pointer<T2>::value and
+    not std::is_reference<T1>::value and not std::is_reference<T2>::value and
+    not (is_ebo_candidate<T1>::value and is_ebo_candidate<T2>::value);
+
+
+// kind of the member type of a table ( of its elements for an array )
+enum table_member_kind : std::uint32_t
+{
+    table_member_integral = 1u << 0,
+    table_member_floating = 1u << 1,
+    table_member_signed   = 1u << 2,
+    table_member_enum     = 1u << 3,
+    table_member_bool     = 1u << 4,
+    table_member_class    = 1u << 5,
+    table_member_array    = 1u << 6,
+};
+
+template <typename T>
+constexpr auto member_kind() noexcept -> std::uint32_t
+{
+    using element_t = std::remove_cv_t<std::remove_all_extents_t<T>>;
+    using value_t   = typename std::conditional_t<std::is_enum<element_t>::value,
+                                                  std::underlying_type<element_t>,
+                                                  std::type_identity<element_t>>::type;
+
+    std::uint32_t kind = 0;
+    if (std::is_integral<value_t>::value)       kind |= table_member_integral;
+    if (std::is_floating_point<value_t>::value) kind |= table_member_floating;
+    if (std::is_signed<value_t>::value)         kind |= table_member_signed;
+    if (std::is_enum<element_t>::value)         kind |= table_member_enum;
+    if (std::is_same<value_t, bool>::value)     kind |= table_member_bool;
+    if (std::is_class<element_t>::value or std::is_union<element_t>::value) kind |= table_member_class;
+    if (std::is_array<T>::value)                kind |= table_member_array;
+    return kind;
+}
+
+template <typename T>
+inline constexpr std::uint64_t member_schema = compressed_pair_table_schema<std::remove_cv_t<std::remove_all_extents_t<T>>>::tag;
+
+
+// the members are private bases or members of compressed_pair, their offsets
+// are measured on an ( all zero ) instance
+template <typename T1, typename T2>
+    requires mappable_pair<T1, T2>
+auto table_layout_of() noexcept -> compressed_pair_table_layout
+{
+    using pair_t = compressed_pair<T1, T2>;
+
+    const auto pair = std::bit_cast<pair_t>(std::array<std::byte, sizeof(pair_t)>{});
+
+    const auto offset_of = [&](const auto& member) -> std::uint64_t {
+        return reinterpret_cast<const std::byte*>(&member) - reinterpret_cast<const std::byte*>(&pair);
+    };
+
+    constexpr bool first_empty  = is_ebo_candidate<T1>::value;
+    constexpr bool second_empty = is_ebo_candidate<T2>::value;
+
+    return {
+        .byte_order        = 0x01020304,
+        .empty_members     = std::uint32_t(first_empty) | std::uint32_t(second_empty) << 1,
+        .element_size      = sizeof(pair_t),
+        .element_alignment = alignof(pair_t),
+        .first_offset      = first_empty  ? 0 : offset_of(pair.first()),
+        .first_size        = first_empty  ? 0 : sizeof(T1),
+        .second_offset     = second_empty ? 0 : offset_of(pair.second()),
+        .second_size       = second_empty ? 0 : sizeof(T2),
+        .first_kind        = first_empty  ? 0 : member_kind<T1>(),
+        .second_kind       = second_empty ? 0 : member_kind<T2>(),
+        .first_schema      = first_empty  ? 0 : member_schema<T1>,
+        .second_schema     = second_empty ? 0 : member_schema<T2>,
+    };
+}
+
+
+// the elements start on a cache line, which mmap keeps aligned
+template <typename T, std::size_t Alignment = std::max<std::size_t>(alignof(T), 64)>
+inline constexpr std::uint64_t table_data_offset =
+    (sizeof(compressed_pair_table_header) + Alignment - 1) / Alignment * Alignment;
+
+
+[[noreturn]] inline void throw_table_system_error(const char* what, const std::string& path)
+{
+    throw std::system_error(errno, std::generic_category(), what + (": " + path));
+}
+
+// closes the descriptor when going out of scope
+class table_file
+{
+
+public:
+    table_file(const std::string& path, int flags, mode_t mode = 0)
+        : m_fd(::open(path.c_str(), flags | O_CLOEXEC, mode))
+    {
+        if (this->m_fd == -1) throw_table_system_error("can't open compressed pair table", path);
+    }
+
+    table_file(const table_file&) = delete;
+    auto operator=(const table_file&) -> table_file& = delete;
+
+    ~table_file() { ::close(this->m_fd); }
+
+    auto fd() const noexcept -> int { return this->m_fd; }
+
+    void sync(const std::string& path) const
+    {
+        if (::fsync(this->m_fd) == -1) throw_table_system_error("can't sync compressed pair table", path);
+    }
+
+    // writes size bytes, retrying after partial writes and interruptions
+    void write(const void* data, std::size_t size, const std::string& path) const
+    {
+        auto* bytes = static_cast<const std::byte*>(data);
+
+        while (size != 0)
+        {
+            const auto written = ::write(this->m_fd, bytes, size);
+            if (written == -1)
+            {
+                if (errno == EINTR) continue;
+                throw_table_system_error("can't write compressed pair table", path);
+            }
+
+            bytes += written;
+            size  -= static_cast<std::size_t>(written);
+        }
+    }
+
+private:
+    int m_fd;
+};
+
+
+// a file next to path, unique to the writing thread
+inline auto temporary_table_path(const std::string& path) -> std::string
+{
+    static std::atomic<std::uint64_t> counter = 0;
+
+    return path + '.' + std::to_string(::getpid()) + '.' + std::to_string(counter++) + ".tmp";
+}
+
+// makes the rename of a table durable, some file systems can't sync a directory
+inline void sync_parent_directory(const std::string& path)
+{
+    const auto slash = path.rfind('/');
+    const auto directory = slash == std::string::npos ? std::string(".")
+                         : slash == 0                 ? std::string("/")
+                                                      : path.substr(0, slash);
+
+    const table_file file(directory, O_RDONLY | O_DIRECTORY);
+    if (::fsync(file.fd()) == -1 and errno != EINVAL)
+    {
+        throw_table_system_error("can't sync the directory of compressed pair table", path);
+    }
+}
+
+}  // namespace detail
+
+/** END **/
+
+
+
+// writes elements as a table to a temporary file, synced to the disk, which
+// then replaces the file at path: a reader sees either the previous table or
+// the new one, and the mappings of the previous table stay valid
+template <typename T1, typename T2>
+    requires detail::mappable_pair<T1, T2>
+void write_compressed_pair_table(const std::string& path, std::span<const compressed_pair<T1, T2>> elements)
+{
+    using pair_t = compressed_pair<T1, T2>;
+
+    compressed_pair_table_header header{};
+    header.magic       = compressed_pair_table_magic;
+    header.version     = compressed_pair_table_version;
+    header.header_size = sizeof(compressed_pair_table_header);
+    header.layout      = detail::table_layout_of<T1, T2>();
+    header.count       = elements.size();
+    header.data_offset = detail::table_data_offset<pair_t>;
+
+    std::array<std::byte, detail::table_data_offset<pair_t>> prefix{};
+    std::memcpy(prefix.data(), &header, sizeof(header));
+
+    const auto temporary = detail::temporary_table_path(path);
+
+    {
+        const detail::table_file file(temporary, O_WRONLY | O_CREAT | O_EXCL, 0644);
+
+        try
+        {
+            file.write(prefix.data(), prefix.size(), temporary);
+            file.write(elements.data(), elements.size_bytes(), temporary);
+            file.sync(temporary);
+        }
+        catch (...)
+        {
+            ::unlink(temporary.c_str());
+            throw;
+        }
+    }
+
+    if (::rename(temporary.c_str(), path.c_str()) == -1)
+    {
+        const int error = errno;
+        ::unlink(temporary.c_str());
+        errno = error;
+        detail::throw_table_system_error("can't replace compressed pair table", path);
+    }
+
+    detail::sync_parent_directory(path);
+}
+
+
+
+// MAIN CLASS
+template <typename T1, typename T2>
+    requires detail::mappable_pair<T1, T2>
+class mapped_compressed_pair_table
+{
+
+public:
+    using value_type     = compressed_pair<T1, T2>;
+    using size_type      = std::size_t;
+    using const_iterator = typename std::span<const value_type>::iterator;
+
+
+public:
+    // maps the table at path, throws compressed_pair_table_error if it isn't a
+    // table of compressed_pair<T1, T2> written with the same layout
+    explicit mapped_compressed_pair_table(const std::string& path)
+    {
+        const detail::table_file file(path, O_RDONLY);
+
+        struct stat status{};
+        if (::fstat(file.fd(), &status) == -1) detail::throw_table_system_error("can't stat compressed pair table", path);
+
+        const auto file_size = static_cast<std::size_t>(status.st_size);
+        if (file_size < sizeof(compressed_pair_table_header))
+        {
+            throw compressed_pair_table_error("not a compressed pair table: " + path);
+        }
+
+        void* mapping = ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, file.fd(), 0);
+        if (mapping == MAP_FAILED) detail::throw_table_system_error("can't map compressed pair table", path);
+
+        this->m_mapping      = mapping;
+        this->m_mapping_size = file_size;
+
+        try
+        {
+            this->m_elements = validate(static_cast<const std::byte*>(mapping), file_size, path);
+        }
+        catch (...)
+        {
+            ::munmap(this->m_mapping, this->m_mapping_size);
+            throw;
+        }
+    }
+
+    mapped_compressed_pair_table(mapped_compressed_pair_table&& other) noexcept
+        : m_mapping(std::exchange(other.m_mapping, nullptr)),
+          m_mapping_size(std::exchange(other.m_mapping_size, 0)),
+          m_elements(std::exchange(other.m_elements, {}))
+    {
+    }
+
+    auto operator=(mapped_compressed_pair_table&& rhs) noexcept -> mapped_compressed_pair_table&
+    {
+        mapped_compressed_pair_table(std::move(rhs)).swap(*this);
+        return *this;
+    }
+
+    ~mapped_compressed_pair_table()
+    {
+        if (this->m_mapping != nullptr) ::munmap(this->m_mapping, this->m_mapping_size);
+    }
+
+
+public:
+    auto elements() const noexcept -> std::span<const value_type> { return this->m_elements; }
+
+    auto operator[](size_type index) const noexcept -> const value_type& { return this->m_elements[index]; }
+
+    auto begin() const noexcept -> const_iterator { return this->m_elements.begin(); }
+    auto end()   const noexcept -> const_iterator { return this->m_elements.end(); }
+
+    auto size()  const noexcept -> size_type { return this->m_elements.size(); }
+    auto empty() const noexcept -> bool      { return this->m_elements.empty(); }
+
+
+public:
+    void swap(mapped_compressed_pair_table& other) noexcept
+    {
+        std::swap(this->m_mapping, other.m_mapping);
+        std::swap(this->m_mapping_size, other.m_mapping_size);
+        std::swap(this->m_elements, other.m_elements);
+    }
+
+
+private:
+    static auto validate(const std::byte* data, std::size_t size, const std::string& path)
+        -> std::span<const value_type>
+    {
+        compressed_pair_table_header header;
+        std::memcpy(&header, data, sizeof(header));
+
+        if (header.magic != compressed_pair_table_magic)
+        {
+            throw compressed_pair_table_error("not a compressed pair table: " + path);
+        }
+
+        if (header.version != compressed_pair_table_version or
+            header.header_size != sizeof(compressed_pair_table_header))
+        {
+            throw compressed_pair_table_error("unsupported compressed pair table version: " + path);
+        }
+
+        if (header.layout != detail::table_layout_of<T1, T2>())
+        {
+            throw compressed_pair_table_error("compressed pair table layout mismatch: " + path);
+        }
+
+        if (header.data_offset % alignof(value_type) != 0 or header.data_offset > size or
+            header.count > (size - header.data_offset) / sizeof(value_type))
+        {
+            throw compressed_pair_table_error("truncated compressed pair table: " + path);
+        }
+
+        // the mapping holds an array of value_type written by write_compressed_pair_table,
+        // which are trivially copyable
+        return {reinterpret_cast<const value_type*>(data + header.data_offset),
+                static_cast<std::size_t>(header.count)};
+    }
+
+private:
+    void* m_mapping = nullptr;
+    std::size_t m_mapping_size = 0;
+    std::span<const value_type> m_elements;
+};
+#endif
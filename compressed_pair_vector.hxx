@@ -0,0 +1,539 @@
+//  ------------------------------------
+//      Copyright (C) 2018 MO ELomari
+//  ------------------------------------
+
+// The compressed pair vector is a "structure of arrays" sequence of
+// compressed_pair: all the first elements and all the second elements are
+// stored in two separate contiguous, SIMD aligned arrays. An empty (non-final)
+// member type doesn't get an array at all, following the same rules as the
+// "empty base-class optimization" of compressed_pair.
+//
+// elements are accessed through compressed_pair<T1&, T2&> proxies, which
+// support structured bindings, and firsts()/seconds() expose each array as a
+// std::span so that loops reading a single member can be vectorized.
+
+#ifndef __COMPRESSED_PAIR_VECTOR_HXX__
+#define __COMPRESSED_PAIR_VECTOR_HXX__
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "compressed_pair.hxx"
+
+
+namespace detail {
+
+// contiguous array of T, aligned for SIMD loads
+template <typename T, bool = is_ebo_candidate<T>::value>
+class soa_column
+{
+
+public:
+    static constexpr std::size_t alignment = std::max<std::size_t>(alignof(T), 64);
+
+
+public:
+    constexpr soa_column() noexcept = default;
+
+
+public:
+    constexpr auto data() const noexcept -> T* { return this->m_data; }
+
+    constexpr auto at(std::size_t index) const noexcept -> T& { return this->m_data[index]; }
+
+    template <typename... ARGS>
+    void construct(std::size_t index, ARGS&&... args) noexcept(
+        std::is_nothrow_constructible<T, ARGS...>::value)
+    {
+        std::construct_at(this->m_data + index, std::forward<ARGS>(args)...);
+    }
+
+    void destroy(std::size_t first, std::size_t last) noexcept
+    {
+        std::destroy(this->m_data + first, this->m_data + last);
+    }
+
+    void swap(soa_column& other) noexcept { std::swap(this->m_data, other.m_data); }
+
+
+public:
+    // largest capacity whose size in bytes fits in a std::ptrdiff_t
+    static constexpr auto max_size() noexcept -> std::size_t
+    {
+        return std::numeric_limits<std::ptrdiff_t>::max() / sizeof(T);
+    }
+
+    static auto allocate(std::size_t capacity) -> T*
+    {
+        return static_cast<T*>(
+            ::operator new(capacity * sizeof(T), std::align_val_t{alignment}));
+    }
+
+    static void deallocate(T* data) noexcept
+    {
+        ::operator delete(data, std::align_val_t{alignment});
+    }
+
+    // true if transfer_to can't throw
+    static constexpr bool nothrow_transfer =
+        is_trivially_relocatable_v<T> or std::is_nothrow_move_constructible<T>::value;
+
+    // moves ( or copies if the move constructor may throw ) the size first
+    // elements into data. the elements of this column are released by
+    // discard once all the columns have been transferred.
+    void transfer_to(T* data, std::size_t size) const
+    {
+        if constexpr (is_trivially_relocatable_v<T>)
+        {
+            if (size != 0) std::memcpy(static_cast<void*>(data), this->m_data, size * sizeof(T));
+        }
+        else if constexpr (std::is_nothrow_move_constructible<T>::value or
+                           not std::is_copy_constructible<T>::value)
+        {
+            std::uninitialized_move_n(this->m_data, size, data);
+        }
+        else
+        {
+            std::uninitialized_copy_n(this->m_data, size, data);
+        }
+    }
+
+    // ends the lifetime of the size first elements after transfer_to
+    void discard(std::size_t size) const noexcept
+    {
+        if constexpr (not is_trivially_relocatable_v<T>)
+        {
+            std::destroy_n(this->m_data, size);
+        }
+    }
+
+    // takes ownership of data, returns the previous array
+    auto reset(T* data) noexcept -> T* { return std::exchange(this->m_data, data); }
+
+
+private:
+    T* m_data = nullptr;
+};
+
+// a stateless type only needs a single instance, shared by all elements
+template <typename T>
+class soa_column<T, true> : private std::remove_cv<T>::type
+{
+
+public:
+    constexpr auto at(std::size_t) const noexcept -> T&
+    {
+        return const_cast<soa_column&>(*this);
+    }
+
+    template <typename... ARGS>
+    void construct(std::size_t, ARGS&&...) noexcept {}
+
+    void destroy(std::size_t, std::size_t) noexcept {}
+
+    void swap(soa_column&) noexcept {}
+
+
+public:
+    static constexpr auto max_size() noexcept -> std::size_t
+    {
+        return std::numeric_limits<std::ptrdiff_t>::max();
+    }
+
+    static auto allocate(std::size_t) noexcept -> std::nullptr_t { return nullptr; }
+
+    static void deallocate(std::nullptr_t) noexcept {}
+
+    static constexpr bool nothrow_transfer = true;
+
+    void transfer_to(std::nullptr_t, std::size_t) const noexcept {}
+
+    void discard(std::size_t) const noexcept {}
+
+    auto reset(std::nullptr_t) noexcept -> std::nullptr_t { return nullptr; }
+};
+
+}  // namespace detail
+
+/** END **/
+
+
+
+// MAIN CLASS
+template <typename T1, typename T2>
+class compressed_pair_vector
+{
+
+public:
+    using first_type      = T1;
+    using second_type     = T2;
+    using value_type      = compressed_pair<T1, T2>;
+    using reference       = compressed_pair<T1&, T2&>;
+    using const_reference = compressed_pair<const T1&, const T2&>;
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+
+public:
+    // random access iterator, dereferencing yields a compressed_pair of references.
+    // it models std::random_access_iterator, and std::sortable when not Const:
+    // the proxies convert to and from value_type, share a common reference with
+    // it, and iter_move/iter_swap move and swap the referred elements.
+    template <bool Const>
+    class basic_iterator
+    {
+
+    public:
+        using iterator_concept  = std::random_access_iterator_tag;
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = compressed_pair<T1, T2>;
+        using difference_type   = std::ptrdiff_t;
+        using reference         = std::conditional_t<Const, const_reference, compressed_pair_vector::reference>;
+        using rvalue_reference  = std::conditional_t<Const, compressed_pair<const T1&&, const T2&&>,
+                                                            compressed_pair<T1&&, T2&&>>;
+        using pointer           = void;
+
+        using owner_type = std::conditional_t<Const, const compressed_pair_vector, compressed_pair_vector>;
+
+
+    public:
+        constexpr basic_iterator() noexcept = default;
+
+        constexpr basic_iterator(owner_type* owner, difference_type index) noexcept
+            : m_owner(owner), m_index(index)
+        {
+        }
+
+        // iterator -> const_iterator
+        template <bool OtherConst>
+        constexpr basic_iterator(const basic_iterator<OtherConst>& other) noexcept
+            requires(Const and not OtherConst)
+            : m_owner(other.m_owner), m_index(other.m_index)
+        {
+        }
+
+
+    public:
+        constexpr auto operator*() const -> reference { return (*this->m_owner)[this->m_index]; }
+        constexpr auto operator[](difference_type n) const -> reference { return (*this->m_owner)[this->m_index + n]; }
+
+        constexpr auto operator++() -> basic_iterator& { ++this->m_index; return *this; }
+        constexpr auto operator--() -> basic_iterator& { --this->m_index; return *this; }
+
+        constexpr auto operator++(int) -> basic_iterator { auto tmp = *this; ++this->m_index; return tmp; }
+        constexpr auto operator--(int) -> basic_iterator { auto tmp = *this; --this->m_index; return tmp; }
+
+        constexpr auto operator+=(difference_type n) -> basic_iterator& { this->m_index += n; return *this; }
+        constexpr auto operator-=(difference_type n) -> basic_iterator& { this->m_index -= n; return *this; }
+
+        friend constexpr auto operator+(basic_iterator it, difference_type n) -> basic_iterator { return it += n; }
+        friend constexpr auto operator+(difference_type n, basic_iterator it) -> basic_iterator { return it += n; }
+        friend constexpr auto operator-(basic_iterator it, difference_type n) -> basic_iterator { return it -= n; }
+
+        friend constexpr auto operator-(const basic_iterator& lhs, const basic_iterator& rhs) -> difference_type
+        {
+            return lhs.m_index - rhs.m_index;
+        }
+
+        friend constexpr auto operator==(const basic_iterator& lhs, const basic_iterator& rhs) -> bool
+        {
+            return lhs.m_index == rhs.m_index;
+        }
+
+        friend constexpr auto operator<=>(const basic_iterator& lhs, const basic_iterator& rhs)
+        {
+            return lhs.m_index <=> rhs.m_index;
+        }
+
+        // the proxy of the referred element as rvalues ( std::ranges::iter_move )
+        friend constexpr auto iter_move(const basic_iterator& it) noexcept -> rvalue_reference
+        {
+            reference element = *it;
+            return rvalue_reference(std::move(element.first()), std::move(element.second()));
+        }
+
+        friend constexpr void iter_swap(const basic_iterator& lhs, const basic_iterator& rhs) noexcept(
+            std::conjunction<std::is_nothrow_swappable<T1>, std::is_nothrow_swappable<T2>>::value)
+            requires(not Const)
+        {
+            ::swap(*lhs, *rhs);
+        }
+
+    private:
+        template <bool> friend class basic_iterator;
+
+        owner_type* m_owner = nullptr;
+        difference_type m_index = 0;
+    };
+
+    using iterator       = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+
+public:
+    constexpr compressed_pair_vector() noexcept = default;
+
+    compressed_pair_vector(const compressed_pair_vector& other)
+        requires(std::conjunction<std::is_copy_constructible<T1>,
+                                  std::is_copy_constructible<T2>>::value)
+    {
+        this->reserve(other.size());
+        for (const auto& [first, second] : other) this->emplace_back(first, second);
+    }
+
+    compressed_pair_vector(compressed_pair_vector&& other) noexcept
+    {
+        this->swap(other);
+    }
+
+    ~compressed_pair_vector()
+    {
+        this->clear();
+        this->release();
+    }
+
+    auto operator=(const compressed_pair_vector& rhs) -> compressed_pair_vector&
+        requires(std::conjunction<std::is_copy_constructible<T1>,
+                                  std::is_copy_constructible<T2>>::value)
+    {
+        if (this != &rhs) compressed_pair_vector(rhs).swap(*this);
+        return *this;
+    }
+
+    auto operator=(compressed_pair_vector&& rhs) noexcept -> compressed_pair_vector&
+    {
+        compressed_pair_vector(std::move(rhs)).swap(*this);
+        return *this;
+    }
+
+
+public:
+    // element access, the result refers to the elements stored in the vector
+    auto operator[](size_type index) -> reference
+    {
+        return reference(this->m_columns.first().at(index),
+                         this->m_columns.second().at(index));
+    }
+
+    auto operator[](size_type index) const -> const_reference
+    {
+        return const_reference(this->m_columns.first().at(index),
+                               this->m_columns.second().at(index));
+    }
+
+    auto front()       -> reference       { return (*this)[0]; }
+    auto front() const -> const_reference { return (*this)[0]; }
+
+    auto back()       -> reference       { return (*this)[this->m_size - 1]; }
+    auto back() const -> const_reference { return (*this)[this->m_size - 1]; }
+
+
+    // contiguous arrays of first and second elements
+    auto firsts() noexcept -> std::span<T1>
+        requires(not detail::is_ebo_candidate<T1>::value)
+    {
+        return {this->aligned(this->m_columns.first().data()), this->m_size};
+    }
+
+    auto firsts() const noexcept -> std::span<const T1>
+        requires(not detail::is_ebo_candidate<T1>::value)
+    {
+        return {this->aligned(this->m_columns.first().data()), this->m_size};
+    }
+
+    auto seconds() noexcept -> std::span<T2>
+        requires(not detail::is_ebo_candidate<T2>::value)
+    {
+        return {this->aligned(this->m_columns.second().data()), this->m_size};
+    }
+
+    auto seconds() const noexcept -> std::span<const T2>
+        requires(not detail::is_ebo_candidate<T2>::value)
+    {
+        return {this->aligned(this->m_columns.second().data()), this->m_size};
+    }
+
+
+public:
+    auto begin()       noexcept -> iterator       { return iterator(this, 0); }
+    auto begin() const noexcept -> const_iterator { return const_iterator(this, 0); }
+
+    auto end()       noexcept -> iterator       { return iterator(this, this->m_size); }
+    auto end() const noexcept -> const_iterator { return const_iterator(this, this->m_size); }
+
+    auto cbegin() const noexcept -> const_iterator { return this->begin(); }
+    auto cend()   const noexcept -> const_iterator { return this->end(); }
+
+
+public:
+    auto size()     const noexcept -> size_type { return this->m_size; }
+    auto capacity() const noexcept -> size_type { return this->m_capacity; }
+    auto empty()    const noexcept -> bool      { return this->m_size == 0; }
+
+    static constexpr auto max_size() noexcept -> size_type
+    {
+        return std::min(detail::soa_column<T1>::max_size(), detail::soa_column<T2>::max_size());
+    }
+
+    // grows both arrays to hold at least capacity elements
+    void reserve(size_type capacity)
+    {
+        if (capacity <= this->m_capacity) return;
+        if (capacity > max_size()) throw std::length_error("compressed_pair_vector::reserve");
+
+        auto& firsts  = this->m_columns.first();
+        auto& seconds = this->m_columns.second();
+
+        auto new_firsts  = firsts.allocate(capacity);
+        auto new_seconds = decltype(seconds.allocate(capacity)){};
+
+        try
+        {
+            new_seconds = seconds.allocate(capacity);
+
+            // the column whose transfer may throw goes first, so that a
+            // failure never leaves moved-from elements in the old arrays
+            if constexpr (detail::soa_column<T1>::nothrow_transfer)
+            {
+                seconds.transfer_to(new_seconds, this->m_size);
+                firsts.transfer_to(new_firsts, this->m_size);
+            }
+            else
+            {
+                firsts.transfer_to(new_firsts, this->m_size);
+                try
+                {
+                    seconds.transfer_to(new_seconds, this->m_size);
+                }
+                catch (...)
+                {
+                    std::destroy_n(new_firsts, this->m_size);
+                    throw;
+                }
+            }
+        }
+        catch (...)
+        {
+            seconds.deallocate(new_seconds);
+            firsts.deallocate(new_firsts);
+            throw;
+        }
+
+        firsts.discard(this->m_size);
+        seconds.discard(this->m_size);
+
+        firsts.deallocate(firsts.reset(new_firsts));
+        seconds.deallocate(seconds.reset(new_seconds));
+        this->m_capacity = capacity;
+    }
+
+    // destroys all the elements, the capacity is unchanged
+    void clear() noexcept
+    {
+        this->m_columns.first().destroy(0, this->m_size);
+        this->m_columns.second().destroy(0, this->m_size);
+        this->m_size = 0;
+    }
+
+
+public:
+    // Appends the element constructed from std::forward<U1>(first) and std::forward<U2>(second).
+    // This function participates in overload resolution if and only if
+    // std::is_constructible<T1, U1> and std::is_constructible<T2, U2> are both true.
+    template <typename U1, typename U2>
+    auto emplace_back(U1&& first, U2&& second) -> reference
+        requires(std::conjunction<std::is_constructible<T1, U1>,
+                                  std::is_constructible<T2, U2>>::value)
+    {
+        if (this->m_size == this->m_capacity)
+        {
+            // the arguments may refer to elements of this vector
+            return this->grow_and_emplace_back(T1(std::forward<U1>(first)),
+                                               T2(std::forward<U2>(second)));
+        }
+
+        auto& firsts  = this->m_columns.first();
+        auto& seconds = this->m_columns.second();
+
+        firsts.construct(this->m_size, std::forward<U1>(first));
+        try
+        {
+            seconds.construct(this->m_size, std::forward<U2>(second));
+        }
+        catch (...)
+        {
+            firsts.destroy(this->m_size, this->m_size + 1);
+            throw;
+        }
+
+        return (*this)[this->m_size++];
+    }
+
+    void push_back(const value_type& value)
+    {
+        this->emplace_back(value.first(), value.second());
+    }
+
+    void push_back(value_type&& value)
+    {
+        this->emplace_back(std::move(value.first()), std::move(value.second()));
+    }
+
+    void pop_back() noexcept
+    {
+        --this->m_size;
+        this->m_columns.first().destroy(this->m_size, this->m_size + 1);
+        this->m_columns.second().destroy(this->m_size, this->m_size + 1);
+    }
+
+
+public:
+    void swap(compressed_pair_vector& other) noexcept
+    {
+        this->m_columns.first().swap(other.m_columns.first());
+        this->m_columns.second().swap(other.m_columns.second());
+        std::swap(this->m_size, other.m_size);
+        std::swap(this->m_capacity, other.m_capacity);
+    }
+
+
+private:
+    template <typename T>
+    static auto aligned(T* data) noexcept -> T*
+    {
+        return std::assume_aligned<detail::soa_column<T>::alignment>(data);
+    }
+
+    auto grow_and_emplace_back(T1&& first, T2&& second) -> reference
+    {
+        this->reserve(this->m_capacity == 0 ? 16 : 2 * this->m_capacity);
+        return this->emplace_back(std::move(first), std::move(second));
+    }
+
+    void release() noexcept
+    {
+        auto& firsts  = this->m_columns.first();
+        auto& seconds = this->m_columns.second();
+
+        firsts.deallocate(firsts.reset(nullptr));
+        seconds.deallocate(seconds.reset(nullptr));
+        this->m_capacity = 0;
+    }
+
+
+private:
+    compressed_pair<detail::soa_column<T1>, detail::soa_column<T2>> m_columns;
+    size_type m_size     = 0;
+    size_type m_capacity = 0;
+};
+#endif
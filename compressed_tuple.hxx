@@ -0,0 +1,331 @@
+//  ------------------------------------
+//      Copyright (C) 2018 MO ELomari
+//  ------------------------------------
+
+// The compressed tuple class is the variadic counterpart of compressed_pair:
+// every empty (non-final) member is stored as a base class, so that it doesn't
+// take any space. packed_compressed_tuple additionally stores the members in
+// descending alignment order to remove the padding between them, while get<I>
+// and structured bindings keep using the declaration order.
+
+#ifndef __COMPRESSED_TUPLE_HXX__
+#define __COMPRESSED_TUPLE_HXX__
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "compressed_pair.hxx"
+
+
+// order in which the members of a compressed tuple are laid out in memory
+enum class tuple_layout
+{
+    declaration_order,
+    alignment_descending
+};
+
+
+namespace detail {
+
+// holds the element of declaration index I, the index keeps the leaves
+// distinct base classes even when the same type appears more than once
+template <std::size_t I, typename T, bool = is_ebo_candidate<T>::value>
+class compressed_tuple_leaf
+{
+
+public:
+    constexpr compressed_tuple_leaf() noexcept(
+        std::is_nothrow_default_constructible<T>::value)
+        requires(std::is_default_constructible<T>::value)
+        : m_value()
+    {
+    }
+
+    template <typename U>
+    constexpr compressed_tuple_leaf(std::in_place_t, U&& value) noexcept(
+        std::is_nothrow_constructible<T, U>::value)
+        : m_value(std::forward<U>(value))
+    {
+    }
+
+public:
+    constexpr auto get() const -> const T& { return this->m_value; }
+    constexpr auto get()       ->       T& { return this->m_value; }
+
+private:
+    T m_value;
+};
+
+template <std::size_t I, typename T>
+class compressed_tuple_leaf<I, T, true> : private std::remove_cv<T>::type
+{
+
+public:
+    constexpr compressed_tuple_leaf() noexcept(
+        std::is_nothrow_default_constructible<T>::value)
+        requires(std::is_default_constructible<T>::value)
+        : std::remove_cv<T>::type()
+    {
+    }
+
+    template <typename U>
+    constexpr compressed_tuple_leaf(std::in_place_t, U&& value) noexcept(
+        std::is_nothrow_constructible<T, U>::value)
+        : std::remove_cv<T>::type(std::forward<U>(value))
+    {
+    }
+
+public:
+    constexpr auto get() const -> const T& { return *this; }
+    constexpr auto get()       ->       T& { return *this; }
+};
+
+
+// alignment of the storage of T, references are stored as pointers.
+// empty members are stored as base classes and don't need any.
+template <typename T>
+inline constexpr std::size_t storage_alignment =
+    is_ebo_candidate<T>::value
+        ? 0
+        : alignof(std::conditional_t<std::is_reference<T>::value, void*, T>);
+
+
+// declaration indices of the members, in the order they are stored
+template <tuple_layout Layout, typename... Ts>
+consteval auto storage_order() -> std::array<std::size_t, sizeof...(Ts)>
+{
+    std::array<std::size_t, sizeof...(Ts)> order{};
+    for (std::size_t i = 0; i != order.size(); ++i) order[i] = i;
+
+    if constexpr (Layout == tuple_layout::alignment_descending)
+    {
+        constexpr std::array<std::size_t, sizeof...(Ts)> alignments{storage_alignment<Ts>...};
+
+        // stable insertion sort, members with the same alignment keep their
+        // declaration order
+        for (std::size_t i = 1; i < order.size(); ++i)
+        {
+            for (std::size_t j = i; j != 0 && alignments[order[j - 1]] < alignments[order[j]]; --j)
+            {
+                std::swap(order[j - 1], order[j]);
+            }
+        }
+    }
+
+    return order;
+}
+
+template <tuple_layout Layout, typename Indices, typename... Ts>
+struct storage_sequence_impl;
+
+template <tuple_layout Layout, std::size_t... Is, typename... Ts>
+struct storage_sequence_impl<Layout, std::index_sequence<Is...>, Ts...>
+{
+    using type = std::index_sequence<storage_order<Layout, Ts...>()[Is]...>;
+};
+
+template <tuple_layout Layout, typename... Ts>
+using storage_sequence = typename storage_sequence_impl<
+    Layout, std::index_sequence_for<Ts...>, Ts...>::type;
+
+
+struct from_tuple_t { explicit from_tuple_t() = default; };
+
+
+// inherits the leaves in storage order
+template <typename Order, typename... Ts>
+class compressed_tuple_storage;
+
+template <std::size_t... Slots, typename... Ts>
+class compressed_tuple_storage<std::index_sequence<Slots...>, Ts...>
+    : public compressed_tuple_leaf<Slots, std::tuple_element_t<Slots, std::tuple<Ts...>>>...
+{
+
+public:
+    constexpr compressed_tuple_storage() = default;
+
+    // constructs each leaf from the element of the same declaration index
+    template <typename Tuple>
+    constexpr compressed_tuple_storage(from_tuple_t, Tuple&& args) noexcept(
+        std::conjunction<std::is_nothrow_constructible<
+            std::tuple_element_t<Slots, std::tuple<Ts...>>,
+            decltype(std::get<Slots>(std::forward<Tuple>(args)))>...>::value)
+        : compressed_tuple_leaf<Slots, std::tuple_element_t<Slots, std::tuple<Ts...>>>(
+              std::in_place, std::get<Slots>(std::forward<Tuple>(args)))...
+    {
+    }
+};
+
+}  // namespace detail
+
+/** END **/
+
+
+
+// MAIN CLASS
+template <tuple_layout Layout, typename... Ts>
+class basic_compressed_tuple
+    : private detail::compressed_tuple_storage<detail::storage_sequence<Layout, Ts...>, Ts...>
+{
+
+public:
+    using base_t = detail::compressed_tuple_storage<detail::storage_sequence<Layout, Ts...>, Ts...>;
+
+    template <std::size_t Index>
+    using element_type = std::tuple_element_t<Index, std::tuple<Ts...>>;
+
+
+public:
+    // Default constructor. Value-initializes all elements
+    constexpr basic_compressed_tuple() = default;
+
+    // Initializes each element with the argument of the same index.
+    // This constructor participates in overload resolution if and only if
+    // std::is_constructible<Ti, Ui> is true for all i.
+    template <typename... Us>
+    constexpr basic_compressed_tuple(Us&&... args) noexcept(
+        std::conjunction<std::is_nothrow_constructible<Ts, Us>...>::value)
+        requires(sizeof...(Us) == sizeof...(Ts) && sizeof...(Ts) != 0) &&
+                (not std::conjunction<
+                     std::bool_constant<sizeof...(Us) == 1>,
+                     std::is_same<std::remove_cvref_t<Us>, basic_compressed_tuple>...>::value) &&
+                (std::conjunction<std::is_constructible<Ts, Us>...>::value)
+        : base_t(detail::from_tuple_t(), std::forward_as_tuple(std::forward<Us>(args)...))
+    {
+    }
+
+
+public:
+    // access the element of declaration index Index
+    template <std::size_t Index>
+    constexpr auto get() & noexcept -> element_type<Index>&
+    {
+        return this->template leaf<Index>().get();
+    }
+
+    template <std::size_t Index>
+    constexpr auto get() const& noexcept -> const element_type<Index>&
+    {
+        return this->template leaf<Index>().get();
+    }
+
+    template <std::size_t Index>
+    constexpr auto get() && noexcept -> element_type<Index>&&
+    {
+        return std::forward<element_type<Index>>(this->template leaf<Index>().get());
+    }
+
+    template <std::size_t Index>
+    constexpr auto get() const&& noexcept -> const element_type<Index>&&
+    {
+        return std::forward<const element_type<Index>>(this->template leaf<Index>().get());
+    }
+
+
+public:
+    void swap(basic_compressed_tuple& other) noexcept(
+        std::conjunction<std::is_nothrow_swappable<Ts>...>::value)
+        requires(std::conjunction<std::is_swappable<Ts>...>::value)
+    {
+        swap_elements(other, std::index_sequence_for<Ts...>());
+    }
+
+private:
+    template <std::size_t Index>
+    constexpr auto leaf() -> detail::compressed_tuple_leaf<Index, element_type<Index>>&
+    {
+        return *this;
+    }
+
+    template <std::size_t Index>
+    constexpr auto leaf() const -> const detail::compressed_tuple_leaf<Index, element_type<Index>>&
+    {
+        return *this;
+    }
+
+    template <std::size_t... Is>
+    void swap_elements(basic_compressed_tuple& other, std::index_sequence<Is...>)
+    {
+        using std::swap;
+        (swap(this->template get<Is>(), other.template get<Is>()), ...);
+    }
+};
+
+
+// members are stored in declaration order
+template <typename... Ts>
+using compressed_tuple = basic_compressed_tuple<tuple_layout::declaration_order, Ts...>;
+
+// members are stored in descending alignment order, to remove padding
+template <typename... Ts>
+using packed_compressed_tuple = basic_compressed_tuple<tuple_layout::alignment_descending, Ts...>;
+
+
+
+// Equality Operators
+
+template <tuple_layout Layout, std::equality_comparable... Ts>
+constexpr auto operator==(const basic_compressed_tuple<Layout, Ts...>& lhs,
+                          const basic_compressed_tuple<Layout, Ts...>& rhs) -> bool
+{
+    return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        return ((lhs.template get<Is>() == rhs.template get<Is>()) && ...);
+    }(std::index_sequence_for<Ts...>());
+}
+
+template <tuple_layout Layout, std::equality_comparable... Ts>
+constexpr auto operator!=(const basic_compressed_tuple<Layout, Ts...>& lhs,
+                          const basic_compressed_tuple<Layout, Ts...>& rhs) -> bool
+{
+    return not(lhs == rhs);
+}
+
+
+
+
+// C++ structured binding support
+namespace std {
+
+template <tuple_layout Layout, typename... Ts>
+struct tuple_size<::basic_compressed_tuple<Layout, Ts...>>
+    : public integral_constant<size_t, sizeof...(Ts)> {};
+
+template <size_t Index, tuple_layout Layout, typename... Ts>
+struct tuple_element<Index, ::basic_compressed_tuple<Layout, Ts...>>
+    : public tuple_element<Index, tuple<Ts...>> {};
+
+}  // namespace std
+
+
+template <std::size_t Index, tuple_layout Layout, typename... Ts>
+constexpr auto get(basic_compressed_tuple<Layout, Ts...>& my_tuple) ->
+    typename std::tuple_element<Index, basic_compressed_tuple<Layout, Ts...>>::type&
+{
+    return my_tuple.template get<Index>();
+}
+
+template <std::size_t Index, tuple_layout Layout, typename... Ts>
+constexpr auto get(const basic_compressed_tuple<Layout, Ts...>& my_tuple) ->
+    typename std::tuple_element<Index, basic_compressed_tuple<Layout, Ts...>>::type const&
+{
+    return my_tuple.template get<Index>();
+}
+
+template <std::size_t Index, tuple_layout Layout, typename... Ts>
+constexpr auto get(basic_compressed_tuple<Layout, Ts...>&& my_tuple) ->
+    typename std::tuple_element<Index, basic_compressed_tuple<Layout, Ts...>>::type&&
+{
+    return std::move(my_tuple).template get<Index>();
+}
+
+template <std::size_t Index, tuple_layout Layout, typename... Ts>
+constexpr auto get(const basic_compressed_tuple<Layout, Ts...>&& my_tuple) ->
+    typename std::tuple_element<Index, basic_compressed_tuple<Layout, Ts...>>::type const&&
+{
+    return std::move(my_tuple).template get<Index>();
+}
+#endif
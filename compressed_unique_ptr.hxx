@@ -0,0 +1,295 @@
+//  ------------------------------------
+//      Copyright (C) 2018 MO ELomari
+//  ------------------------------------
+
+// The compressed unique pointer class is a std::unique_ptr which stores its
+// deleter and its pointer in a compressed_pair: a stateless deleter doesn't
+// take any space, whatever the implementation of the standard library.
+//
+// allocator_delete destroys and deallocates through an allocator, so that
+// allocate_compressed_unique can create objects in a monotonic_arena, a
+// fixed_pool or any other allocator; a stateless allocator still costs nothing.
+
+#ifndef __COMPRESSED_UNIQUE_PTR_HXX__
+#define __COMPRESSED_UNIQUE_PTR_HXX__
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "compressed_pair.hxx"
+
+
+namespace detail {
+
+// Deleter::pointer if it names a type, T* otherwise
+template <typename T, typename Deleter>
+struct deleter_pointer
+{
+    using type = T*;
+};
+
+template <typename T, typename Deleter>
+    requires requires { typename Deleter::pointer; }
+struct deleter_pointer<T, Deleter>
+{
+    using type = typename Deleter::pointer;
+};
+
+}  // namespace detail
+
+/** END **/
+
+
+
+// MAIN CLASS
+template <typename T, typename Deleter = std::default_delete<T>>
+class compressed_unique_ptr
+{
+    static_assert(not std::is_array<T>::value, "compressed_unique_ptr manages a single object");
+
+public:
+    using element_type = T;
+    using deleter_type = Deleter;
+    using pointer      = typename detail::deleter_pointer<T, std::remove_reference_t<Deleter>>::type;
+
+
+public:
+    // Default constructor. Owns nothing
+    constexpr compressed_unique_ptr() noexcept
+        requires(std::conjunction<std::is_default_constructible<Deleter>,
+                                  std::negation<std::is_pointer<Deleter>>>::value)
+        : m_pair()
+    {
+    }
+
+    constexpr compressed_unique_ptr(std::nullptr_t) noexcept
+        requires(std::conjunction<std::is_default_constructible<Deleter>,
+                                  std::negation<std::is_pointer<Deleter>>>::value)
+        : m_pair()
+    {
+    }
+
+    // takes ownership of ptr, which is released by a value-initialized deleter
+    constexpr explicit compressed_unique_ptr(pointer ptr) noexcept
+        requires(std::conjunction<std::is_default_constructible<Deleter>,
+                                  std::negation<std::is_pointer<Deleter>>>::value)
+        : m_pair(Deleter(), ptr)
+    {
+    }
+
+    // takes ownership of ptr, which is released by the deleter initialized with
+    // std::forward<D>(deleter). a reference deleter can't bind to an rvalue.
+    template <typename D>
+    constexpr compressed_unique_ptr(pointer ptr, D&& deleter) noexcept(
+        std::is_nothrow_constructible<Deleter, D>::value)
+        requires(std::is_constructible<Deleter, D>::value) &&
+                (not std::is_reference<Deleter>::value or std::is_lvalue_reference<D>::value)
+        : m_pair(std::forward<D>(deleter), ptr)
+    {
+    }
+
+    constexpr compressed_unique_ptr(compressed_unique_ptr&& other) noexcept
+        requires(std::is_move_constructible<Deleter>::value)
+        : m_pair(std::forward<Deleter>(other.get_deleter()), other.release())
+    {
+    }
+
+    // compressed_unique_ptr<Derived> -> compressed_unique_ptr<Base>
+    template <typename U, typename E>
+    constexpr compressed_unique_ptr(compressed_unique_ptr<U, E>&& other) noexcept
+        requires(std::is_convertible<typename compressed_unique_ptr<U, E>::pointer, pointer>::value) &&
+                (std::is_reference<Deleter>::value ? std::is_same<E, Deleter>::value
+                                                   : std::is_convertible<E, Deleter>::value)
+        : m_pair(std::forward<E>(other.get_deleter()), other.release())
+    {
+    }
+
+    compressed_unique_ptr(const compressed_unique_ptr&) = delete;
+    auto operator=(const compressed_unique_ptr&) -> compressed_unique_ptr& = delete;
+
+    constexpr ~compressed_unique_ptr()
+    {
+        if (this->get() != pointer()) this->get_deleter()(this->get());
+    }
+
+    constexpr auto operator=(compressed_unique_ptr&& rhs) noexcept -> compressed_unique_ptr&
+        requires(std::is_move_assignable<Deleter>::value)
+    {
+        this->reset(rhs.release());
+        this->get_deleter() = std::forward<Deleter>(rhs.get_deleter());
+        return *this;
+    }
+
+    template <typename U, typename E>
+    constexpr auto operator=(compressed_unique_ptr<U, E>&& rhs) noexcept -> compressed_unique_ptr&
+        requires(std::is_convertible<typename compressed_unique_ptr<U, E>::pointer, pointer>::value) &&
+                (std::is_assignable<Deleter&, E&&>::value)
+    {
+        this->reset(rhs.release());
+        this->get_deleter() = std::forward<E>(rhs.get_deleter());
+        return *this;
+    }
+
+    constexpr auto operator=(std::nullptr_t) noexcept -> compressed_unique_ptr&
+    {
+        this->reset();
+        return *this;
+    }
+
+
+public:
+    constexpr auto get() const noexcept -> pointer { return this->m_pair.second(); }
+
+    constexpr auto get_deleter()       noexcept ->       Deleter& { return this->m_pair.first(); }
+    constexpr auto get_deleter() const noexcept -> const Deleter& { return this->m_pair.first(); }
+
+    constexpr explicit operator bool() const noexcept { return this->get() != pointer(); }
+
+    constexpr auto operator*() const -> std::add_lvalue_reference_t<T> { return *this->get(); }
+    constexpr auto operator->() const noexcept -> pointer { return this->get(); }
+
+
+public:
+    // gives up the ownership of the object without destroying it
+    constexpr auto release() noexcept -> pointer
+    {
+        return std::exchange(this->m_pair.second(), pointer());
+    }
+
+    // destroys the owned object, if any, and takes ownership of ptr
+    constexpr void reset(pointer ptr = pointer()) noexcept
+    {
+        const auto old = std::exchange(this->m_pair.second(), ptr);
+        if (old != pointer()) this->get_deleter()(old);
+    }
+
+    constexpr void swap(compressed_unique_ptr& other) noexcept
+        requires(std::is_swappable<Deleter>::value)
+    {
+        this->m_pair.swap(other.m_pair);
+    }
+
+
+private:
+    compressed_pair<Deleter, pointer> m_pair;
+};
+
+
+template <typename T, typename D1, typename U, typename D2>
+constexpr auto operator==(const compressed_unique_ptr<T, D1>& lhs,
+                          const compressed_unique_ptr<U, D2>& rhs) -> bool
+{
+    return lhs.get() == rhs.get();
+}
+
+template <typename T, typename Deleter>
+constexpr auto operator==(const compressed_unique_ptr<T, Deleter>& lhs, std::nullptr_t) noexcept -> bool
+{
+    return not lhs;
+}
+
+
+template <typename T, typename Deleter>
+constexpr void swap(compressed_unique_ptr<T, Deleter>& lhs, compressed_unique_ptr<T, Deleter>& rhs) noexcept
+    requires(std::is_swappable<Deleter>::value)
+{
+    lhs.swap(rhs);
+}
+
+
+// the pointer may be a fancy pointer ( Deleter::pointer ) whose value depends on
+// its address, a reference deleter is relocated as the address it holds
+template <typename T, typename Deleter>
+struct is_trivially_relocatable<compressed_unique_ptr<T, Deleter>>
+    : public std::conjunction<is_trivially_relocatable<typename compressed_unique_ptr<T, Deleter>::pointer>,
+                              std::disjunction<std::is_reference<Deleter>, is_trivially_relocatable<Deleter>>> {};
+
+
+template <typename T, typename... ARGS>
+constexpr auto make_compressed_unique(ARGS&&... args) -> compressed_unique_ptr<T>
+    requires(not std::is_array<T>::value)
+{
+    return compressed_unique_ptr<T>(new T(std::forward<ARGS>(args)...));
+}
+
+
+
+// deleter which destroys and deallocates a single object through an allocator
+template <typename Allocator, bool = detail::is_ebo_candidate<Allocator>::value>
+class allocator_delete
+{
+
+public:
+    using allocator_type = Allocator;
+    using pointer        = typename std::allocator_traits<Allocator>::pointer;
+
+
+public:
+    constexpr allocator_delete(const Allocator& allocator) noexcept : m_allocator(allocator) {}
+
+    constexpr void operator()(pointer ptr)
+    {
+        std::allocator_traits<Allocator>::destroy(this->m_allocator, std::to_address(ptr));
+        std::allocator_traits<Allocator>::deallocate(this->m_allocator, ptr, 1);
+    }
+
+    constexpr auto get_allocator() const noexcept -> Allocator { return this->m_allocator; }
+
+private:
+    Allocator m_allocator;
+};
+
+// a stateless allocator is stored as a base class and doesn't take any space
+template <typename Allocator>
+class allocator_delete<Allocator, true> : private Allocator
+{
+
+public:
+    using allocator_type = Allocator;
+    using pointer        = typename std::allocator_traits<Allocator>::pointer;
+
+
+public:
+    constexpr allocator_delete(const Allocator& allocator) noexcept : Allocator(allocator) {}
+
+    constexpr void operator()(pointer ptr)
+    {
+        Allocator& allocator = *this;
+        std::allocator_traits<Allocator>::destroy(allocator, std::to_address(ptr));
+        std::allocator_traits<Allocator>::deallocate(allocator, ptr, 1);
+    }
+
+    constexpr auto get_allocator() const noexcept -> Allocator { return *this; }
+};
+
+
+// allocates a T through allocator ( rebound to T ) and constructs it from
+// std::forward<ARGS>(args)..., the object is destroyed and deallocated through
+// a copy of the same allocator
+template <typename T, typename Allocator, typename... ARGS>
+auto allocate_compressed_unique(const Allocator& allocator, ARGS&&... args)
+    -> compressed_unique_ptr<T, allocator_delete<
+           typename std::allocator_traits<Allocator>::template rebind_alloc<T>>>
+    requires(not std::is_array<T>::value)
+{
+    using allocator_t = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+    using traits_t    = std::allocator_traits<allocator_t>;
+
+    allocator_t rebound(allocator);
+    const auto ptr = traits_t::allocate(rebound, 1);
+
+    try
+    {
+        traits_t::construct(rebound, std::to_address(ptr), std::forward<ARGS>(args)...);
+    }
+    catch (...)
+    {
+        traits_t::deallocate(rebound, ptr, 1);
+        throw;
+    }
+
+    return {ptr, allocator_delete<allocator_t>(rebound)};
+}
+#endif
@@ -0,0 +1,363 @@
+//  ------------------------------------
+//      Copyright (C) 2018 MO ELomari
+//  ------------------------------------
+
+// Memory resources for the allocator-aware compressed containers:
+//
+//   - monotonic_arena: bump allocation in geometrically growing chunks,
+//     deallocation is a no-op and everything is released at once,
+//   - fixed_pool: blocks of a single size recycled through a free list,
+//     larger or over-aligned requests are forwarded to ::operator new.
+//
+// resource_allocator<T, Resource> is the stateful allocator ( a single pointer
+// to the resource ) which plugs them into compressed_buffer,
+// allocate_compressed_unique or any standard container, and
+// memory_resource_adaptor exposes them as a std::pmr::memory_resource.
+
+#ifndef __MEMORY_ARENA_HXX__
+#define __MEMORY_ARENA_HXX__
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+// MAIN CLASS
+class monotonic_arena
+{
+
+public:
+    static constexpr std::size_t default_chunk_size = 4096;
+
+
+public:
+    // the first chunk is allocated on the first request
+    explicit monotonic_arena(std::size_t initial_chunk_size = default_chunk_size) noexcept
+        : m_next_chunk_size(std::max<std::size_t>(initial_chunk_size, sizeof(chunk_header)))
+    {
+    }
+
+    // the requests are served from buffer first, the arena doesn't own it
+    monotonic_arena(void* buffer, std::size_t size) noexcept
+        : m_current(static_cast<std::byte*>(buffer)),
+          m_end(static_cast<std::byte*>(buffer) + size),
+          m_buffer(static_cast<std::byte*>(buffer)),
+          m_buffer_size(size),
+          m_next_chunk_size(std::max<std::size_t>(2 * size, default_chunk_size))
+    {
+    }
+
+    monotonic_arena(const monotonic_arena&) = delete;
+    auto operator=(const monotonic_arena&) -> monotonic_arena& = delete;
+
+    ~monotonic_arena() { this->release(); }
+
+
+public:
+    auto allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) -> void*
+    {
+        void* ptr = this->m_current;
+        auto space = static_cast<std::size_t>(this->m_end - this->m_current);
+
+        if (std::align(alignment, bytes, ptr, space) == nullptr)
+        {
+            return this->allocate_from_new_chunk(bytes, alignment);
+        }
+
+        this->m_current = static_cast<std::byte*>(ptr) + bytes;
+        return ptr;
+    }
+
+    // the memory is only reclaimed by release
+    void deallocate(void*, std::size_t, std::size_t = alignof(std::max_align_t)) noexcept {}
+
+    // frees all the chunks, the next requests are served from the initial buffer again
+    void release() noexcept
+    {
+        while (this->m_chunks != nullptr)
+        {
+            auto* chunk = std::exchange(this->m_chunks, this->m_chunks->previous);
+            ::operator delete(static_cast<void*>(chunk), chunk->size);
+        }
+
+        this->m_current = this->m_buffer;
+        this->m_end     = this->m_buffer + this->m_buffer_size;
+    }
+
+
+private:
+    struct chunk_header
+    {
+        chunk_header* previous;
+        std::size_t size;
+    };
+
+    auto allocate_from_new_chunk(std::size_t bytes, std::size_t alignment) -> void*
+    {
+        if (bytes > std::numeric_limits<std::size_t>::max() / 2 - alignment) throw std::bad_alloc();
+
+        const std::size_t required = sizeof(chunk_header) + bytes + alignment;
+        const std::size_t size     = std::max(this->m_next_chunk_size, required);
+
+        auto* chunk = static_cast<chunk_header*>(::operator new(size));
+        this->m_chunks = ::new (static_cast<void*>(chunk)) chunk_header{this->m_chunks, size};
+
+        this->m_current = reinterpret_cast<std::byte*>(chunk) + sizeof(chunk_header);
+        this->m_end     = reinterpret_cast<std::byte*>(chunk) + size;
+        this->m_next_chunk_size = 2 * size;
+
+        return this->allocate(bytes, alignment);
+    }
+
+private:
+    std::byte* m_current = nullptr;
+    std::byte* m_end     = nullptr;
+    chunk_header* m_chunks = nullptr;
+
+    std::byte* m_buffer = nullptr;
+    std::size_t m_buffer_size = 0;
+    std::size_t m_next_chunk_size;
+};
+
+
+
+// MAIN CLASS
+class fixed_pool
+{
+
+public:
+    static constexpr std::size_t default_blocks_per_chunk = 256;
+
+
+public:
+    // serves the requests of at most block_size bytes aligned on at most block_alignment
+    explicit fixed_pool(std::size_t block_size,
+                        std::size_t block_alignment  = alignof(std::max_align_t),
+                        std::size_t blocks_per_chunk = default_blocks_per_chunk) noexcept
+        : m_block_alignment(std::max(block_alignment, alignof(free_block))),
+          m_block_size(round_up(std::max(block_size, sizeof(free_block)), m_block_alignment)),
+          m_blocks_per_chunk(std::max<std::size_t>(blocks_per_chunk, 1))
+    {
+    }
+
+    fixed_pool(const fixed_pool&) = delete;
+    auto operator=(const fixed_pool&) -> fixed_pool& = delete;
+
+    ~fixed_pool() { this->release(); }
+
+
+public:
+    auto block_size() const noexcept -> std::size_t { return this->m_block_size; }
+
+    auto allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) -> void*
+    {
+        if (not this->fits(bytes, alignment))
+        {
+            return ::operator new(bytes, std::align_val_t{alignment});
+        }
+
+        if (this->m_free != nullptr)
+        {
+            return std::exchange(this->m_free, this->m_free->next);
+        }
+
+        // the blocks of the last chunk are handed out lazily, so that the
+        // pages of a chunk are only touched once they are used
+        if (this->m_current == this->m_end) this->allocate_chunk();
+
+        return std::exchange(this->m_current, this->m_current + this->m_block_size);
+    }
+
+    void deallocate(void* ptr, std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) noexcept
+    {
+        if (not this->fits(bytes, alignment))
+        {
+            ::operator delete(ptr, bytes, std::align_val_t{alignment});
+            return;
+        }
+
+        this->m_free = ::new (ptr) free_block{this->m_free};
+    }
+
+    // frees all the chunks, including the blocks still in use
+    void release() noexcept
+    {
+        while (this->m_chunks != nullptr)
+        {
+            auto* chunk = std::exchange(this->m_chunks, this->m_chunks->previous);
+            ::operator delete(static_cast<void*>(chunk), this->chunk_size(),
+                              std::align_val_t{this->m_block_alignment});
+        }
+
+        this->m_free    = nullptr;
+        this->m_current = nullptr;
+        this->m_end     = nullptr;
+    }
+
+
+private:
+    struct free_block
+    {
+        free_block* next;
+    };
+
+    struct chunk_header
+    {
+        chunk_header* previous;
+    };
+
+    static constexpr auto round_up(std::size_t size, std::size_t alignment) noexcept -> std::size_t
+    {
+        return (size + alignment - 1) / alignment * alignment;
+    }
+
+    auto fits(std::size_t bytes, std::size_t alignment) const noexcept -> bool
+    {
+        return bytes <= this->m_block_size and alignment <= this->m_block_alignment;
+    }
+
+    // the header is padded to keep the blocks aligned
+    auto header_size() const noexcept -> std::size_t
+    {
+        return round_up(sizeof(chunk_header), this->m_block_alignment);
+    }
+
+    auto chunk_size() const noexcept -> std::size_t
+    {
+        return this->header_size() + this->m_blocks_per_chunk * this->m_block_size;
+    }
+
+    void allocate_chunk()
+    {
+        auto* chunk = static_cast<std::byte*>(
+            ::operator new(this->chunk_size(), std::align_val_t{this->m_block_alignment}));
+
+        this->m_chunks = ::new (static_cast<void*>(chunk)) chunk_header{this->m_chunks};
+
+        this->m_current = chunk + this->header_size();
+        this->m_end     = chunk + this->chunk_size();
+    }
+
+private:
+    free_block* m_free = nullptr;
+    std::byte* m_current = nullptr;
+    std::byte* m_end     = nullptr;
+    chunk_header* m_chunks = nullptr;
+
+    std::size_t m_block_alignment;
+    std::size_t m_block_size;
+    std::size_t m_blocks_per_chunk;
+};
+
+/** END **/
+
+
+
+// stateful allocator referring to a monotonic_arena, a fixed_pool or any type
+// with the same allocate/deallocate members. the resource must outlive the
+// allocator and the memory allocated through it.
+template <typename T, typename Resource>
+class resource_allocator
+{
+
+public:
+    using value_type      = T;
+    using resource_type   = Resource;
+    using size_type       = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    // containers exchange their resource along with their memory when they
+    // are moved or swapped, copies keep their own resource
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap            = std::true_type;
+    using is_always_equal                        = std::false_type;
+
+
+public:
+    constexpr resource_allocator(Resource& resource) noexcept : m_resource(&resource) {}
+
+    template <typename U>
+    constexpr resource_allocator(const resource_allocator<U, Resource>& other) noexcept
+        : m_resource(other.resource())
+    {
+    }
+
+
+public:
+    [[nodiscard]] auto allocate(size_type count) -> T*
+    {
+        if (count > std::numeric_limits<size_type>::max() / sizeof(T))
+        {
+            throw std::bad_array_new_length();
+        }
+
+        return static_cast<T*>(this->m_resource->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* ptr, size_type count) noexcept
+    {
+        this->m_resource->deallocate(ptr, count * sizeof(T), alignof(T));
+    }
+
+    constexpr auto resource() const noexcept -> Resource* { return this->m_resource; }
+
+
+public:
+    template <typename U>
+    friend constexpr auto operator==(const resource_allocator& lhs,
+                                     const resource_allocator<U, Resource>& rhs) noexcept -> bool
+    {
+        return lhs.resource() == rhs.resource();
+    }
+
+private:
+    Resource* m_resource;
+};
+
+
+template <typename T>
+using arena_allocator = resource_allocator<T, monotonic_arena>;
+
+template <typename T>
+using pool_allocator = resource_allocator<T, fixed_pool>;
+
+
+
+// exposes a resource to the std::pmr containers
+template <typename Resource>
+class memory_resource_adaptor final : public std::pmr::memory_resource
+{
+
+public:
+    explicit memory_resource_adaptor(Resource& resource) noexcept : m_resource(&resource) {}
+
+    auto resource() const noexcept -> Resource* { return this->m_resource; }
+
+
+private:
+    auto do_allocate(std::size_t bytes, std::size_t alignment) -> void* override
+    {
+        return this->m_resource->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override
+    {
+        this->m_resource->deallocate(ptr, bytes, alignment);
+    }
+
+    auto do_is_equal(const std::pmr::memory_resource& other) const noexcept -> bool override
+    {
+        const auto* adaptor = dynamic_cast<const memory_resource_adaptor*>(&other);
+        return adaptor != nullptr and adaptor->m_resource == this->m_resource;
+    }
+
+private:
+    Resource* m_resource;
+};
+#endif
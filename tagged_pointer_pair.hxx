@@ -0,0 +1,306 @@
+//  ------------------------------------
+//      Copyright (C) 2018 MO ELomari
+//  ------------------------------------
+
+// The tagged pointer pair holds a T* and a small value V ( bool, or an
+// enumeration or integer whose range is declared through packed_value_traits )
+// in a single word, V being stored in the spare low alignment bits of the
+// pointer. it has the first()/second()/get<I> interface of compressed_pair,
+// the members of a non-const pair are accessed through proxy references.
+//
+// the layout doesn't depend on T: the pair is always a single word, also when
+// T is incomplete where the pair is declared ( a node holding a pair of a
+// pointer to itself ). the alignment of T is checked where the pointer is
+// stored or loaded, T must be complete there.
+
+#ifndef __TAGGED_POINTER_PAIR_HXX__
+#define __TAGGED_POINTER_PAIR_HXX__
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+
+// number of bits needed to store the values of V in a tagged_pointer_pair.
+// specialize it for enumerations and small integers, e.g.
+//
+//   template <> struct packed_value_traits<color> { static constexpr std::size_t bits = 1; };
+//
+// the stored values must be in the range [0, 2^bits).
+template <typename V>
+struct packed_value_traits
+{
+    static constexpr std::size_t bits = 0;
+};
+
+template <>
+struct packed_value_traits<bool>
+{
+    static constexpr std::size_t bits = 1;
+};
+
+
+
+namespace detail {
+
+// encodes a pointer to T and a value of V in a single word
+template <typename T, typename V>
+struct tagged_pointer_codec
+{
+    using pointer_type = T*;
+    using value_type   = V;
+
+    static constexpr std::size_t bits = packed_value_traits<V>::bits;
+    static constexpr std::uintptr_t value_mask = (std::uintptr_t(1) << bits) - 1;
+
+    // the pair only needs T where the pointer is stored or loaded
+    static constexpr void check_alignment() noexcept
+    {
+        static_assert(requires { sizeof(T); },
+                      "T must be complete where the pointer of a tagged_pointer_pair is used");
+
+        if constexpr (requires { sizeof(T); })
+        {
+            static_assert(alignof(T) >= (std::size_t(1) << bits),
+                          "the alignment of T doesn't leave enough spare bits for V");
+        }
+    }
+
+    // a reinterpret_cast isn't a constant expression, only null pointers can
+    // be stored and loaded at compile time
+    static constexpr auto pointer(std::uintptr_t word) noexcept -> T*
+    {
+        check_alignment();
+
+        if (std::is_constant_evaluated() and (word & ~value_mask) == 0) return nullptr;
+        return reinterpret_cast<T*>(word & ~value_mask);
+    }
+
+    static constexpr auto value(std::uintptr_t word) noexcept -> V
+    {
+        if constexpr (std::is_same<V, bool>::value) return (word & value_mask) != 0;
+        else return static_cast<V>(word & value_mask);
+    }
+
+    static constexpr auto with_pointer(std::uintptr_t word, T* pointer) noexcept -> std::uintptr_t
+    {
+        check_alignment();
+
+        if (std::is_constant_evaluated() and pointer == nullptr) return word & value_mask;
+        return reinterpret_cast<std::uintptr_t>(pointer) | (word & value_mask);
+    }
+
+    static constexpr auto fits(V value) noexcept -> bool
+    {
+        return (static_cast<std::uintptr_t>(value) & ~value_mask) == 0;
+    }
+
+    // a value out of the range declared by packed_value_traits ( or negative )
+    // would be truncated: it isn't a constant expression, and asserts at run time
+    static constexpr auto with_value(std::uintptr_t word, V value) noexcept -> std::uintptr_t
+    {
+        if (std::is_constant_evaluated() and not fits(value)) value_out_of_range();
+        assert(fits(value) and "the value of a tagged_pointer_pair must be in [0, 2^packed_value_traits<V>::bits)");
+
+        return (word & ~value_mask) | static_cast<std::uintptr_t>(value);
+    }
+
+private:
+    static void value_out_of_range() noexcept {}
+};
+
+
+// proxy reference to the member Index of a tagged_pointer_pair
+template <typename Codec, std::size_t Index>
+class tagged_reference
+{
+
+public:
+    using value_type = std::conditional_t<Index == 0, typename Codec::pointer_type,
+                                          typename Codec::value_type>;
+
+
+public:
+    constexpr explicit tagged_reference(std::uintptr_t& word) noexcept : m_word(word) {}
+
+    constexpr tagged_reference(const tagged_reference&) noexcept = default;
+
+
+public:
+    constexpr auto get() const noexcept -> value_type
+    {
+        if constexpr (Index == 0) return Codec::pointer(this->m_word);
+        else return Codec::value(this->m_word);
+    }
+
+    constexpr operator value_type() const noexcept { return this->get(); }
+
+    constexpr auto operator=(value_type value) const noexcept -> const tagged_reference&
+    {
+        if constexpr (Index == 0) this->m_word = Codec::with_pointer(this->m_word, value);
+        else this->m_word = Codec::with_value(this->m_word, value);
+
+        return *this;
+    }
+
+    // assigns the referenced value, like a built-in reference
+    constexpr auto operator=(const tagged_reference& other) const noexcept -> const tagged_reference&
+    {
+        return *this = other.get();
+    }
+
+    constexpr auto operator->() const noexcept -> value_type requires(Index == 0)
+    {
+        return this->get();
+    }
+
+    constexpr auto operator*() const noexcept -> decltype(auto) requires(Index == 0)
+    {
+        return *this->get();
+    }
+
+    friend constexpr void swap(const tagged_reference& lhs, const tagged_reference& rhs) noexcept
+    {
+        value_type tmp = lhs.get();
+        lhs = rhs.get();
+        rhs = tmp;
+    }
+
+private:
+    std::uintptr_t& m_word;
+};
+
+}  // namespace detail
+
+/** END **/
+
+
+
+// MAIN CLASS
+template <typename T, typename V>
+class tagged_pointer_pair
+{
+    static_assert(std::is_object<T>::value, "T must be an object type");
+    static_assert(std::is_integral<V>::value or std::is_enum<V>::value,
+                  "V must be bool, an integer or an enumeration");
+    static_assert(packed_value_traits<V>::bits != 0,
+                  "the range of V must be declared through packed_value_traits");
+
+    using codec = detail::tagged_pointer_codec<T, V>;
+
+public:
+    using first_type  = T*;
+    using second_type = V;
+
+    // proxy references to the members of a non-const pair
+    using first_reference  = detail::tagged_reference<codec, 0>;
+    using second_reference = detail::tagged_reference<codec, 1>;
+
+
+public:
+    // Default constructor. Value-initializes both elements of the pair, first and second
+    constexpr tagged_pointer_pair() noexcept : m_word(0) {}
+
+    // Initializes first with first and second with second
+    constexpr tagged_pointer_pair(first_type first, second_type second) noexcept
+        : m_word(codec::with_value(codec::with_pointer(0, first), second))
+    {
+    }
+
+
+public:
+    // access first element of a pair
+    constexpr auto first() const&  noexcept -> first_type      { return codec::pointer(this->m_word); }
+    constexpr auto first()      &  noexcept -> first_reference { return first_reference(this->m_word); }
+
+    constexpr auto first() const&& noexcept -> first_type      { return codec::pointer(this->m_word); }
+    constexpr auto first()      && noexcept -> first_type      { return codec::pointer(this->m_word); }
+
+    // access second element of a pair
+    constexpr auto second() const&  noexcept -> second_type      { return codec::value(this->m_word); }
+    constexpr auto second()      &  noexcept -> second_reference { return second_reference(this->m_word); }
+
+    constexpr auto second() const&& noexcept -> second_type      { return codec::value(this->m_word); }
+    constexpr auto second()      && noexcept -> second_type      { return codec::value(this->m_word); }
+
+
+public:
+    constexpr void swap(tagged_pointer_pair& other) noexcept
+    {
+        std::swap(this->m_word, other.m_word);
+    }
+
+    friend constexpr void swap(tagged_pointer_pair& lhs, tagged_pointer_pair& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    friend constexpr auto operator==(const tagged_pointer_pair&, const tagged_pointer_pair&) -> bool = default;
+
+
+private:
+    std::uintptr_t m_word;
+};
+
+
+
+// tuple interface: the elements of a non-const pair are the proxy references,
+// so that auto& [pointer, value] = pair; value = v; assigns the pair. the
+// elements of a const pair are values.
+namespace std {
+
+template <typename T, typename V>
+struct tuple_size<::tagged_pointer_pair<T, V>> : public integral_constant<size_t, 2> {};
+
+template <size_t Index, typename T, typename V>
+struct tuple_element<Index, ::tagged_pointer_pair<T, V>>
+{
+    using type = conditional_t<Index == 0, typename ::tagged_pointer_pair<T, V>::first_reference,
+                                           typename ::tagged_pointer_pair<T, V>::second_reference>;
+};
+
+template <size_t Index, typename T, typename V>
+struct tuple_element<Index, const ::tagged_pointer_pair<T, V>>
+{
+    using type = conditional_t<Index == 0, typename ::tagged_pointer_pair<T, V>::first_type,
+                                           typename ::tagged_pointer_pair<T, V>::second_type>;
+};
+
+}  // namespace std
+
+
+template <std::size_t Index, typename T, typename V>
+constexpr auto get(tagged_pointer_pair<T, V>& my_pair) noexcept -> std::tuple_element_t<Index, tagged_pointer_pair<T, V>>
+{
+    if constexpr (Index == 0) return my_pair.first();
+    if constexpr (Index == 1) return my_pair.second();
+}
+
+template <std::size_t Index, typename T, typename V>
+constexpr auto get(const tagged_pointer_pair<T, V>& my_pair) noexcept -> std::tuple_element_t<Index, const tagged_pointer_pair<T, V>>
+{
+    if constexpr (Index == 0) return my_pair.first();
+    if constexpr (Index == 1) return my_pair.second();
+}
+
+// a value, as first() && and second() &&: a proxy would refer to the storage
+// of the rvalue once it's destroyed. the members of a non-const pair can't be
+// bound by value ( auto [pointer, value] = make_pair(); ), the elements of a
+// const pair can ( const auto [pointer, value] = make_pair(); ).
+template <std::size_t Index, typename T, typename V>
+constexpr auto get(tagged_pointer_pair<T, V>&& my_pair) noexcept -> std::tuple_element_t<Index, const tagged_pointer_pair<T, V>>
+{
+    if constexpr (Index == 0) return std::move(my_pair).first();
+    if constexpr (Index == 1) return std::move(my_pair).second();
+}
+
+template <std::size_t Index, typename T, typename V>
+constexpr auto get(const tagged_pointer_pair<T, V>&& my_pair) noexcept -> std::tuple_element_t<Index, const tagged_pointer_pair<T, V>>
+{
+    if constexpr (Index == 0) return my_pair.first();
+    if constexpr (Index == 1) return my_pair.second();
+}
+#endif
@@ -0,0 +1,146 @@
+//  ------------------------------------
+//      Copyright (C) 2018 MO ELomari
+//  ------------------------------------
+
+// built twice, with and without -mcx16 when the compiler supports it, so that
+// both the double-width and the spin lock storage of 16 bytes pairs are tested
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "atomic_compressed_pair.hxx"
+
+
+namespace {
+
+// next is read by the threads whose compare-exchange is about to fail
+struct node
+{
+    std::atomic<node*> next = nullptr;
+    int value = 0;
+};
+
+using head_t = compressed_pair<node*, std::uint64_t>;
+
+// lock-free stack, the version counter of the head avoids ABA
+class treiber_stack
+{
+
+public:
+    void push(node* n) noexcept
+    {
+        auto old = this->m_head.load();
+        do { n->next.store(old.first(), std::memory_order_relaxed); }
+        while (not this->m_head.compare_exchange_weak(old, head_t(n, old.second() + 1)));
+    }
+
+    // the nodes are never freed while the stack is used, reading the next
+    // pointer of a node popped by another thread is safe
+    auto pop() noexcept -> node*
+    {
+        auto old = this->m_head.load();
+        while (old.first() != nullptr and
+               not this->m_head.compare_exchange_weak(old, head_t(old.first()->next.load(std::memory_order_relaxed),
+                                                                  old.second() + 1)))
+        {
+        }
+        return old.first();
+    }
+
+private:
+    atomic_compressed_pair<node*, std::uint64_t> m_head;
+};
+
+}  // namespace
+
+
+TEST(atomic_compressed_pair, load_store_exchange)
+{
+    node a;
+    node b;
+
+    atomic_compressed_pair<node*, std::uint64_t> head(head_t(&a, 1));
+    EXPECT_EQ(head.load(), head_t(&a, 1));
+
+    head.store(head_t(&b, 2));
+    EXPECT_EQ(head.exchange(head_t(&a, 3)), head_t(&b, 2));
+    EXPECT_EQ(static_cast<head_t>(head), head_t(&a, 3));
+}
+
+TEST(atomic_compressed_pair, compare_exchange_updates_expected)
+{
+    node a;
+
+    atomic_compressed_pair<node*, std::uint64_t> head(head_t(&a, 1));
+
+    head_t expected(&a, 2);
+    EXPECT_FALSE(head.compare_exchange_strong(expected, head_t(nullptr, 3)));
+    EXPECT_EQ(expected, head_t(&a, 1));
+
+    EXPECT_TRUE(head.compare_exchange_strong(expected, head_t(nullptr, 3)));
+    EXPECT_EQ(head.load(), head_t(nullptr, 3));
+}
+
+TEST(atomic_compressed_pair, larger_pairs_use_a_lock)
+{
+    using wide_t = compressed_pair<std::uint64_t, compressed_pair<std::uint64_t, std::uint64_t>>;
+    static_assert(not atomic_compressed_pair<std::uint64_t, compressed_pair<std::uint64_t, std::uint64_t>>::is_always_lock_free);
+
+    atomic_compressed_pair<std::uint64_t, compressed_pair<std::uint64_t, std::uint64_t>> value;
+
+    wide_t expected;
+    const wide_t desired(1, compressed_pair<std::uint64_t, std::uint64_t>(2, 3));
+    EXPECT_TRUE(value.compare_exchange_strong(expected, desired));
+    EXPECT_EQ(value.exchange(wide_t()), desired);
+}
+
+TEST(atomic_compressed_pair, concurrent_treiber_stack_keeps_every_node)
+{
+    constexpr std::size_t thread_count = 4;
+    constexpr std::size_t node_count   = 1000;
+
+    std::vector<node> nodes(thread_count * node_count);
+    for (std::size_t i = 0; i != nodes.size(); ++i) nodes[i].value = static_cast<int>(i);
+
+    treiber_stack stack;
+
+    // every thread pushes its nodes and pops as many, many times
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t != thread_count; ++t)
+    {
+        threads.emplace_back([&stack, &nodes, t] {
+            std::vector<node*> popped;
+            for (int round = 0; round != 20; ++round)
+            {
+                for (std::size_t i = 0; i != node_count; ++i)
+                {
+                    stack.push(round == 0 ? &nodes[t * node_count + i] : popped[i]);
+                }
+
+                popped.clear();
+                while (popped.size() != node_count)
+                {
+                    if (auto n = stack.pop(); n != nullptr) popped.push_back(n);
+                }
+            }
+
+            for (auto n : popped) stack.push(n);
+        });
+    }
+
+    for (auto& thread : threads) thread.join();
+
+    std::vector<bool> seen(nodes.size());
+    for (auto n = stack.pop(); n != nullptr; n = stack.pop())
+    {
+        EXPECT_FALSE(seen[static_cast<std::size_t>(n->value)]);
+        seen[static_cast<std::size_t>(n->value)] = true;
+    }
+
+    for (std::size_t i = 0; i != seen.size(); ++i) EXPECT_TRUE(seen[i]) << "node " << i << " was lost";
+}
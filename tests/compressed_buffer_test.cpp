@@ -0,0 +1,220 @@
+//  ------------------------------------
+//      Copyright (C) 2018 MO ELomari
+//  ------------------------------------
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "compressed_buffer.hxx"
+#include "memory_arena.hxx"
+
+
+namespace {
+
+// points to itself, a relocation with memcpy would leave it pointing to the
+// old storage
+struct self_referencing
+{
+    explicit self_referencing(int value) noexcept : value(value) {}
+
+    self_referencing(const self_referencing& other) noexcept : value(other.value) {}
+    self_referencing(self_referencing&& other) noexcept : value(other.value) {}
+
+    auto operator=(const self_referencing& other) noexcept -> self_referencing&
+    {
+        this->value = other.value;
+        return *this;
+    }
+
+    const self_referencing* self = this;
+    int value;
+};
+
+static_assert(not is_trivially_relocatable_v<self_referencing>);
+
+// an arena allocator with the given propagation on assignment and swap
+template <typename T, bool Propagate>
+class propagating_allocator : public resource_allocator<T, monotonic_arena>
+{
+
+public:
+    using propagate_on_container_copy_assignment = std::bool_constant<Propagate>;
+    using propagate_on_container_move_assignment = std::bool_constant<Propagate>;
+    using propagate_on_container_swap            = std::bool_constant<Propagate>;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = propagating_allocator<U, Propagate>;
+    };
+
+    using resource_allocator<T, monotonic_arena>::resource_allocator;
+};
+
+using strings_t = compressed_buffer<std::string, arena_allocator<std::string>>;
+
+// an arena served from an owned buffer, so that the memory of a buffer can
+// be told apart from the memory of another arena
+struct buffered_arena
+{
+    auto owns(const void* ptr) const noexcept -> bool
+    {
+        const auto* byte = static_cast<const std::byte*>(ptr);
+        return byte >= this->buffer and byte < this->buffer + sizeof(this->buffer);
+    }
+
+    alignas(std::max_align_t) std::byte buffer[4096];
+    monotonic_arena arena{buffer, sizeof(buffer)};
+};
+
+template <typename Buffer>
+void fill(Buffer& buffer, int count)
+{
+    for (int i = 0; i != count; ++i) buffer.emplace_back(std::to_string(i));
+}
+
+}  // namespace
+
+
+TEST(compressed_buffer, growth_moves_non_trivially_relocatable_elements)
+{
+    compressed_buffer<self_referencing> buffer;
+    for (int i = 0; i != 100; ++i) buffer.emplace_back(i);
+
+    EXPECT_GE(buffer.capacity(), 100u);
+    for (int i = 0; i != 100; ++i)
+    {
+        EXPECT_EQ(buffer[i].value, i);
+        EXPECT_EQ(buffer[i].self, &buffer[i]);
+    }
+
+    // the argument refers to an element which is moved by the growth
+    while (buffer.size() != buffer.capacity()) buffer.emplace_back(0);
+    buffer.push_back(buffer[1]);
+    EXPECT_EQ(buffer.back().value, 1);
+    EXPECT_EQ(buffer.back().self, &buffer.back());
+}
+
+TEST(compressed_buffer, copy_construction_and_assignment)
+{
+    compressed_buffer<std::string> source;
+    fill(source, 20);
+
+    const compressed_buffer<std::string> copy(source);
+    ASSERT_EQ(copy.size(), 20u);
+    EXPECT_EQ(copy[19], "19");
+
+    compressed_buffer<std::string> assigned;
+    fill(assigned, 3);
+    assigned = copy;
+    ASSERT_EQ(assigned.size(), copy.size());
+    for (std::size_t i = 0; i != copy.size(); ++i) EXPECT_EQ(assigned[i], copy[i]);
+    EXPECT_NE(assigned.data(), copy.data());
+}
+
+TEST(compressed_buffer, copy_assignment_keeps_the_arena)
+{
+    buffered_arena lhs_arena;
+    buffered_arena rhs_arena;
+
+    strings_t lhs(lhs_arena.arena);
+    strings_t rhs(rhs_arena.arena);
+    fill(rhs, 10);
+
+    // arena_allocator doesn't propagate on copy assignment
+    lhs = rhs;
+    EXPECT_EQ(lhs.get_allocator().resource(), &lhs_arena.arena);
+    EXPECT_TRUE(lhs_arena.owns(lhs.data()));
+    ASSERT_EQ(lhs.size(), 10u);
+    EXPECT_EQ(lhs[9], "9");
+}
+
+TEST(compressed_buffer, copy_assignment_propagates_the_arena)
+{
+    using buffer_t = compressed_buffer<std::string, propagating_allocator<std::string, true>>;
+
+    buffered_arena lhs_arena;
+    buffered_arena rhs_arena;
+
+    buffer_t lhs(lhs_arena.arena);
+    buffer_t rhs(rhs_arena.arena);
+    fill(lhs, 5);
+    fill(rhs, 10);
+
+    lhs = rhs;
+    EXPECT_EQ(lhs.get_allocator().resource(), &rhs_arena.arena);
+    EXPECT_TRUE(rhs_arena.owns(lhs.data()));
+    ASSERT_EQ(lhs.size(), 10u);
+    EXPECT_EQ(lhs[9], "9");
+}
+
+TEST(compressed_buffer, move_assignment_propagates_the_arena)
+{
+    buffered_arena lhs_arena;
+    buffered_arena rhs_arena;
+
+    strings_t lhs(lhs_arena.arena);
+    strings_t rhs(rhs_arena.arena);
+    fill(lhs, 5);
+    fill(rhs, 10);
+
+    // arena_allocator propagates on move assignment, the storage is stolen
+    const auto* storage = rhs.data();
+    lhs = std::move(rhs);
+    EXPECT_EQ(lhs.get_allocator().resource(), &rhs_arena.arena);
+    EXPECT_EQ(lhs.data(), storage);
+    EXPECT_EQ(lhs.size(), 10u);
+    EXPECT_TRUE(rhs.empty());
+}
+
+TEST(compressed_buffer, move_assignment_between_unequal_arenas_moves_the_elements)
+{
+    using buffer_t = compressed_buffer<std::string, propagating_allocator<std::string, false>>;
+    static_assert(not noexcept(std::declval<buffer_t&>() = std::declval<buffer_t&&>()));
+
+    buffered_arena lhs_arena;
+    buffered_arena rhs_arena;
+
+    buffer_t lhs(lhs_arena.arena);
+    buffer_t rhs(rhs_arena.arena);
+    fill(lhs, 5);
+    fill(rhs, 10);
+
+    // the memory of rhs can't be deallocated through the arena of lhs
+    lhs = std::move(rhs);
+    EXPECT_EQ(lhs.get_allocator().resource(), &lhs_arena.arena);
+    EXPECT_TRUE(lhs_arena.owns(lhs.data()));
+    ASSERT_EQ(lhs.size(), 10u);
+    EXPECT_EQ(lhs[9], "9");
+    EXPECT_TRUE(rhs.empty());
+
+    // between equal allocators the storage is stolen
+    buffer_t same(lhs_arena.arena);
+    const auto* storage = lhs.data();
+    same = std::move(lhs);
+    EXPECT_EQ(same.data(), storage);
+}
+
+TEST(compressed_buffer, pop_back_clear_and_swap)
+{
+    compressed_buffer<std::string> lhs;
+    compressed_buffer<std::string> rhs;
+    fill(lhs, 3);
+
+    lhs.pop_back();
+    EXPECT_EQ(lhs.size(), 2u);
+    EXPECT_EQ(lhs.back(), "1");
+
+    swap(lhs, rhs);
+    EXPECT_TRUE(lhs.empty());
+    EXPECT_EQ(rhs.size(), 2u);
+
+    const auto capacity = rhs.capacity();
+    rhs.clear();
+    EXPECT_TRUE(rhs.empty());
+    EXPECT_EQ(rhs.capacity(), capacity);
+}
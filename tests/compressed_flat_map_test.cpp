@@ -0,0 +1,218 @@
+//  ------------------------------------
+//      Copyright (C) 2018 MO ELomari
+//  ------------------------------------
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "compressed_flat_map.hxx"
+
+
+namespace {
+
+struct present {};
+
+using map_t = compressed_flat_map<int, std::string>;
+
+// the key can't be assigned through an iterator
+static_assert(std::forward_iterator<map_t::iterator>);
+static_assert(std::forward_iterator<map_t::const_iterator>);
+static_assert(std::is_same<std::iter_reference_t<map_t::iterator>, compressed_pair<const int&, std::string&>>::value);
+static_assert(not std::is_assignable<decltype(std::declval<map_t::iterator>()->first()), int>::value);
+static_assert(std::is_assignable<decltype(std::declval<map_t::iterator>()->second()), std::string>::value);
+
+// counts the live instances, its copies throw once the countdown reaches 0
+// and its move constructor may throw, so that the map copies it when it grows
+struct fragile
+{
+    static inline int alive     = 0;
+    static inline int countdown = -1;
+
+    explicit fragile(int value) : value(value) { ++alive; }
+
+    fragile(const fragile& other) : value(other.value)
+    {
+        if (countdown == 0) throw std::runtime_error("copy");
+        if (countdown > 0) --countdown;
+        ++alive;
+    }
+
+    fragile(fragile&& other) noexcept(false) : value(other.value) { ++alive; }
+
+    ~fragile() { --alive; }
+
+    int value;
+};
+
+}  // namespace
+
+
+TEST(compressed_flat_map, insert_find_and_erase)
+{
+    compressed_flat_map<int, int> values;
+    for (int i = 0; i != 1000; ++i) EXPECT_TRUE(values.try_emplace(i, i * 2).second);
+    EXPECT_FALSE(values.try_emplace(7, 0).second);
+    EXPECT_EQ(values.size(), 1000u);
+
+    for (int i = 0; i != 1000; ++i)
+    {
+        const auto it = values.find(i);
+        ASSERT_NE(it, values.end());
+        EXPECT_EQ(it->second(), i * 2);
+    }
+    EXPECT_EQ(values.find(1000), values.end());
+
+    for (int i = 0; i != 1000; i += 2) EXPECT_EQ(values.erase(i), 1u);
+    EXPECT_EQ(values.size(), 500u);
+    EXPECT_FALSE(values.contains(0));
+    EXPECT_TRUE(values.contains(1));
+}
+
+TEST(compressed_flat_map, reuses_deleted_slots)
+{
+    // erase/insert cycles at a constant size don't grow the table
+    compressed_flat_map<int, int> values(64);
+    for (int i = 0; i != 48; ++i) values.try_emplace(i, i);
+
+    const auto capacity = values.capacity();
+    for (int i = 48; i != 10'000; ++i)
+    {
+        values.erase(i - 48);
+        values.try_emplace(i, i);
+    }
+
+    EXPECT_EQ(values.size(), 48u);
+    EXPECT_EQ(values.capacity(), capacity);
+    for (int i = 10'000 - 48; i != 10'000; ++i) EXPECT_EQ(values[i], i);
+}
+
+TEST(compressed_flat_map, iteration_exposes_the_key_as_const)
+{
+    map_t values;
+    values[1] = "one";
+    values[2] = "two";
+
+    for (auto&& [key, value] : values) value += std::to_string(key);
+
+    EXPECT_EQ(values[1], "one1");
+    EXPECT_EQ(values[2], "two2");
+
+    std::size_t count = 0;
+    for (const auto& [key, value] : std::as_const(values)) count += static_cast<std::size_t>(key) + value.size();
+    EXPECT_EQ(count, 1u + 4u + 2u + 4u);
+}
+
+TEST(compressed_flat_map, matches_std_unordered_map)
+{
+    compressed_flat_map<std::uint64_t, std::uint64_t> values;
+    std::unordered_map<std::uint64_t, std::uint64_t> expected;
+
+    std::uint64_t key = 1;
+    for (int i = 0; i != 20'000; ++i)
+    {
+        key = key * 6364136223846793005u + 1442695040888963407u;
+        const auto k = key >> 52;
+
+        if (i % 3 == 0)
+        {
+            EXPECT_EQ(values.erase(k), expected.erase(k));
+        }
+        else
+        {
+            values[k] += 1;
+            expected[k] += 1;
+        }
+    }
+
+    ASSERT_EQ(values.size(), expected.size());
+    for (const auto& [k, v] : values) EXPECT_EQ(expected.at(k), v);
+}
+
+TEST(compressed_flat_map, set_and_move_only_values)
+{
+    compressed_flat_map<std::string, present> names;
+    EXPECT_TRUE(names.try_emplace("compressed_pair").second);
+    EXPECT_FALSE(names.try_emplace("compressed_pair").second);
+    EXPECT_EQ(names.count("compressed_pair"), 1u);
+
+    compressed_flat_map<int, std::unique_ptr<int>> owners;
+    for (int i = 0; i != 100; ++i) owners.try_emplace(i, std::make_unique<int>(i));
+
+    auto moved = std::move(owners);
+    EXPECT_TRUE(owners.empty());
+    EXPECT_EQ(*moved.find(42)->second(), 42);
+}
+
+TEST(compressed_flat_map, pointer_keys_and_bool_values)
+{
+    int nodes[3] = {};
+
+    compressed_flat_map<int*, bool> visited;
+    visited[nodes + 1] = true;
+    visited[nodes + 2];
+
+    EXPECT_TRUE(visited[nodes + 1]);
+    EXPECT_FALSE(visited[nodes + 2]);
+    EXPECT_FALSE(visited.contains(nodes));
+}
+
+TEST(compressed_flat_map, copy)
+{
+    compressed_flat_map<int, std::string> values;
+    for (int i = 0; i != 100; ++i) values[i] = std::to_string(i);
+
+    const auto copy = values;
+    EXPECT_EQ(copy.size(), 100u);
+    EXPECT_EQ(copy.find(42)->second(), "42");
+}
+
+TEST(compressed_flat_map, try_emplace_arguments_may_refer_to_elements)
+{
+    // the value is copied from an element of the map while the map grows
+    compressed_flat_map<int, std::string> values;
+    values.try_emplace(0, std::string(100, 'x'));
+
+    for (int i = 1; i != 1000; ++i)
+    {
+        const auto capacity = values.capacity();
+        values.try_emplace(i, values.find(i - 1)->second());
+        ASSERT_EQ(values.find(i)->second(), std::string(100, 'x')) << "capacity " << capacity;
+    }
+}
+
+TEST(compressed_flat_map, throwing_copy_during_growth_leaves_the_map_unchanged)
+{
+    {
+        compressed_flat_map<int, fragile> values;
+        for (int i = 0; i != 14; ++i) values.try_emplace(i, i);
+        ASSERT_EQ(values.size(), values.capacity() - values.capacity() / 8);
+
+        // the next insertion grows the table, the 5th copy of an element throws
+        const auto capacity = values.capacity();
+        fragile::countdown = 4;
+        EXPECT_THROW(values.try_emplace(14, 14), std::runtime_error);
+        fragile::countdown = -1;
+
+        EXPECT_EQ(values.capacity(), capacity);
+        EXPECT_EQ(values.size(), 14u);
+        EXPECT_EQ(fragile::alive, 14);
+        for (int i = 0; i != 14; ++i) EXPECT_EQ(values.find(i)->second().value, i);
+
+        // and it still grows
+        values.try_emplace(14, 14);
+        EXPECT_GT(values.capacity(), capacity);
+        EXPECT_EQ(values.find(14)->second().value, 14);
+        EXPECT_EQ(fragile::alive, 15);
+    }
+
+    EXPECT_EQ(fragile::alive, 0);
+}
@@ -0,0 +1,158 @@
+//  ------------------------------------
+//      Copyright (C) 2018 MO ELomari
+//  ------------------------------------
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "compressed_pair_table.hxx"
+
+
+namespace {
+
+struct price
+{
+    std::uint32_t cents;
+    std::uint32_t currency;
+};
+
+struct quantity
+{
+    std::uint32_t units;
+    std::uint32_t lots;
+};
+
+}  // namespace
+
+template <>
+struct compressed_pair_table_schema<price>
+{
+    static constexpr std::uint64_t tag = 1;
+};
+
+template <>
+struct compressed_pair_table_schema<quantity>
+{
+    static constexpr std::uint64_t tag = 2;
+};
+
+namespace {
+
+struct empty_tag {};
+
+// a table file in the temporary directory, removed by the destructor
+class table_path
+{
+
+public:
+    explicit table_path(const std::string& name)
+        : m_path((std::filesystem::temp_directory_path() / (name + ".cpt")).string())
+    {
+    }
+
+    ~table_path() { std::remove(this->m_path.c_str()); }
+
+    auto str() const -> const std::string& { return this->m_path; }
+
+private:
+    std::string m_path;
+};
+
+template <typename T1, typename T2>
+void write_table(const table_path& path, const std::vector<compressed_pair<T1, T2>>& elements)
+{
+    write_compressed_pair_table<T1, T2>(path.str(), elements);
+}
+
+}  // namespace
+
+
+TEST(compressed_pair_table, round_trip)
+{
+    const table_path path("round_trip");
+
+    std::vector<compressed_pair<std::uint64_t, double>> prices;
+    for (std::uint64_t i = 0; i != 1000; ++i) prices.emplace_back(i, 0.5 * static_cast<double>(i));
+    write_table(path, prices);
+
+    const mapped_compressed_pair_table<std::uint64_t, double> table(path.str());
+    ASSERT_EQ(table.size(), prices.size());
+    for (std::size_t i = 0; i != prices.size(); ++i) EXPECT_EQ(table[i], prices[i]);
+}
+
+TEST(compressed_pair_table, empty_members_take_no_space)
+{
+    const table_path path("empty_members");
+
+    write_table<int, empty_tag>(path, {compressed_pair<int, empty_tag>(1, {}), compressed_pair<int, empty_tag>(2, {})});
+
+    const mapped_compressed_pair_table<int, empty_tag> table(path.str());
+    ASSERT_EQ(table.size(), 2u);
+    EXPECT_EQ(table[1].first(), 2);
+    using tagged_t = compressed_pair<int, empty_tag>;
+    EXPECT_EQ(std::filesystem::file_size(path.str()), detail::table_data_offset<tagged_t> + 2 * sizeof(int));
+}
+
+TEST(compressed_pair_table, rejects_other_member_types_of_the_same_layout)
+{
+    const table_path path("member_types");
+
+    write_table<int, double>(path, {compressed_pair<int, double>(1, 2.0)});
+
+    using float_table    = mapped_compressed_pair_table<float, double>;
+    using unsigned_table = mapped_compressed_pair_table<unsigned, double>;
+    EXPECT_THROW(float_table{path.str()}, compressed_pair_table_error);
+    EXPECT_THROW(unsigned_table{path.str()}, compressed_pair_table_error);
+    EXPECT_NO_THROW((mapped_compressed_pair_table<int, double>(path.str())));
+}
+
+TEST(compressed_pair_table, rejects_other_schemas)
+{
+    const table_path path("schemas");
+
+    write_table<price, int>(path, {compressed_pair<price, int>(price{100, 1}, 3)});
+
+    using quantity_table = mapped_compressed_pair_table<quantity, int>;
+    EXPECT_THROW(quantity_table{path.str()}, compressed_pair_table_error);
+
+    const mapped_compressed_pair_table<price, int> table(path.str());
+    EXPECT_EQ(table[0].first().cents, 100u);
+}
+
+TEST(compressed_pair_table, rewriting_keeps_the_mapped_table)
+{
+    const table_path path("rewrite");
+
+    std::vector<compressed_pair<int, int>> before;
+    for (int i = 0; i != 100'000; ++i) before.emplace_back(i, -i);
+    write_table(path, before);
+
+    const mapped_compressed_pair_table<int, int> mapped(path.str());
+
+    // a shorter table replaces the file, the pages of the mapped one stay readable
+    write_table<int, int>(path, {compressed_pair<int, int>(7, 7)});
+
+    ASSERT_EQ(mapped.size(), before.size());
+    EXPECT_EQ(mapped[before.size() - 1], before.back());
+
+    const mapped_compressed_pair_table<int, int> reopened(path.str());
+    ASSERT_EQ(reopened.size(), 1u);
+    EXPECT_EQ(reopened[0], (compressed_pair<int, int>(7, 7)));
+
+    // no temporary file is left behind
+    const auto directory = std::filesystem::path(path.str()).parent_path();
+    for (const auto& entry : std::filesystem::directory_iterator(directory))
+    {
+        EXPECT_EQ(entry.path().string().find(path.str() + '.'), std::string::npos) << entry.path();
+    }
+}
+
+TEST(compressed_pair_table, missing_directory_throws)
+{
+    EXPECT_THROW((write_compressed_pair_table<int, int>("/nonexistent/table.cpt", {})), std::system_error);
+}
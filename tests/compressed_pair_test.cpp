@@ -0,0 +1,355 @@
+//  ------------------------------------
+//      Copyright (C) 2018 MO ELomari
+//  ------------------------------------
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "compressed_pair.hxx"
+
+
+namespace {
+
+struct empty1 {};
+struct empty2 {};
+
+struct stateless_less
+{
+    auto operator()(int lhs, int rhs) const -> bool { return lhs < rhs; }
+};
+
+// opts in to trivial relocation but counts its moves, a relocation with
+// memmove doesn't call the move constructor
+struct counted_relocatable
+{
+    static inline int moves = 0;
+
+    counted_relocatable() = default;
+    counted_relocatable(counted_relocatable&&) noexcept { ++moves; }
+};
+
+// empty member counting its copies and moves
+struct counted_empty
+{
+    static inline int copies_and_moves = 0;
+
+    counted_empty() = default;
+    explicit counted_empty(int) {}
+    counted_empty(const counted_empty&) { ++copies_and_moves; }
+    counted_empty(counted_empty&&) noexcept { ++copies_and_moves; }
+};
+
+// empty member which can be neither copied nor moved
+struct pinned_empty
+{
+    pinned_empty() = default;
+    explicit pinned_empty(int) {}
+    pinned_empty(pinned_empty&&) = delete;
+};
+
+// non-empty member counting its copies and its moves
+struct counted_value
+{
+    static inline int copies = 0;
+    static inline int moves  = 0;
+
+    explicit counted_value(int value) noexcept : value(value) {}
+    counted_value(const counted_value& other) noexcept : value(other.value) { ++copies; }
+    counted_value(counted_value&& other) noexcept : value(other.value) { ++moves; }
+
+    int value;
+};
+
+// non-empty member which can be neither copied nor moved
+struct pinned_value
+{
+    explicit pinned_value(int value) noexcept : value(value) {}
+    pinned_value(pinned_value&&) = delete;
+
+    int value;
+};
+
+}  // namespace
+
+template <>
+struct is_trivially_relocatable<counted_relocatable> : public std::true_type {};
+
+
+TEST(compressed_pair, default_constructor_value_initializes)
+{
+    compressed_pair<int, double> values;
+    EXPECT_EQ(values.first(), 0);
+    EXPECT_EQ(values.second(), 0.0);
+
+    compressed_pair<empty1, std::string> with_empty;
+    EXPECT_TRUE(with_empty.second().empty());
+}
+
+TEST(compressed_pair, constructs_all_four_specializations)
+{
+    compressed_pair<int, std::string> both(1, "one");
+    EXPECT_EQ(both.first(), 1);
+    EXPECT_EQ(both.second(), "one");
+
+    compressed_pair<stateless_less, int> first_empty(stateless_less(), 2);
+    EXPECT_TRUE(first_empty.first()(1, first_empty.second()));
+
+    compressed_pair<int, stateless_less> second_empty(3, stateless_less());
+    EXPECT_FALSE(second_empty.second()(second_empty.first(), 3));
+
+    compressed_pair<empty1, empty2> none;
+    static_cast<void>(none.first());
+    static_cast<void>(none.second());
+}
+
+TEST(compressed_pair, piecewise_construct)
+{
+    compressed_pair<std::string, std::pair<int, int>> values(
+        std::piecewise_construct, std::forward_as_tuple(3, 'x'), std::forward_as_tuple(4, 5));
+
+    EXPECT_EQ(values.first(), "xxx");
+    EXPECT_EQ(values.second(), std::make_pair(4, 5));
+}
+
+TEST(compressed_pair, piecewise_constructs_empty_bases_in_place)
+{
+    static_assert(std::is_empty<counted_empty>::value);
+    counted_empty::copies_and_moves = 0;
+
+    compressed_pair<counted_empty, int> first_empty(
+        std::piecewise_construct, std::forward_as_tuple(1), std::forward_as_tuple(2));
+    compressed_pair<int, counted_empty> second_empty(
+        std::piecewise_construct, std::forward_as_tuple(1), std::forward_as_tuple(2));
+    compressed_pair<counted_empty, empty1> both_empty(
+        std::piecewise_construct, std::forward_as_tuple(1), std::forward_as_tuple());
+
+    EXPECT_EQ(counted_empty::copies_and_moves, 0);
+    EXPECT_EQ(sizeof(first_empty), sizeof(int));
+    EXPECT_EQ(sizeof(second_empty), sizeof(int));
+    EXPECT_EQ(first_empty.second(), 2);
+    EXPECT_EQ(second_empty.first(), 1);
+
+    compressed_pair<pinned_empty, int> pinned(
+        std::piecewise_construct, std::forward_as_tuple(1), std::forward_as_tuple(3));
+    EXPECT_EQ(pinned.second(), 3);
+
+    // a factory result is moved into a base class
+    static_assert(not std::is_constructible<compressed_pair<pinned_empty, int>, std::in_place_t,
+                                            pinned_empty (*)(), int (*)()>::value);
+
+    compressed_pair<counted_empty, int> from_factory(
+        std::in_place, [] { return counted_empty(1); }, [] { return 4; });
+    EXPECT_EQ(counted_empty::copies_and_moves, 1);
+}
+
+TEST(compressed_pair, piecewise_moves_non_empty_members_once)
+{
+    counted_value::copies = 0;
+    counted_value::moves  = 0;
+
+    counted_value first(1);
+    counted_value second(2);
+
+    compressed_pair<counted_value, counted_value> both(
+        std::piecewise_construct, std::forward_as_tuple(std::move(first)), std::forward_as_tuple(std::move(second)));
+    EXPECT_EQ(counted_value::moves, 2);
+
+    compressed_pair<counted_value, empty1> second_empty(
+        std::piecewise_construct, std::forward_as_tuple(std::move(first)), std::forward_as_tuple());
+    EXPECT_EQ(counted_value::moves, 3);
+
+    compressed_pair<empty1, counted_value> first_empty(
+        std::piecewise_construct, std::forward_as_tuple(), std::forward_as_tuple(std::move(second)));
+    EXPECT_EQ(counted_value::moves, 4);
+
+    EXPECT_EQ(counted_value::copies, 0);
+    EXPECT_EQ(both.first().value, 1);
+    EXPECT_EQ(second_empty.first().value, 1);
+    EXPECT_EQ(first_empty.second().value, 2);
+}
+
+TEST(compressed_pair, piecewise_takes_a_tuple_per_member)
+{
+    // whichever member is empty
+    using single_tuple = std::tuple<int&&>;
+    static_assert(not std::is_constructible<compressed_pair<int, int>, std::piecewise_construct_t, single_tuple>::value);
+    static_assert(not std::is_constructible<compressed_pair<empty1, int>, std::piecewise_construct_t, single_tuple>::value);
+    static_assert(not std::is_constructible<compressed_pair<int, empty1>, std::piecewise_construct_t, single_tuple>::value);
+    static_assert(not std::is_constructible<compressed_pair<empty1, empty2>, std::piecewise_construct_t, std::tuple<>>::value);
+}
+
+TEST(compressed_pair, in_place_elides_non_empty_members)
+{
+    // the guaranteed copy elision constructs a non-movable member from the factory result
+    compressed_pair<pinned_value, int> both(
+        std::in_place, [] { return pinned_value(5); }, [] { return 6; });
+    EXPECT_EQ(both.first().value, 5);
+    EXPECT_EQ(both.second(), 6);
+
+    compressed_pair<empty1, pinned_value> first_empty(
+        std::in_place, [] { return empty1(); }, [] { return pinned_value(7); });
+    EXPECT_EQ(first_empty.second().value, 7);
+
+    compressed_pair<pinned_value, empty1> second_empty(
+        std::in_place, [] { return pinned_value(8); }, [] { return empty1(); });
+    EXPECT_EQ(second_empty.first().value, 8);
+}
+
+TEST(compressed_pair, in_place_construct)
+{
+    compressed_pair<std::string, int> values(
+        std::in_place, [] { return std::string("abc"); }, [] { return 7; });
+
+    EXPECT_EQ(values.first(), "abc");
+    EXPECT_EQ(values.second(), 7);
+}
+
+TEST(compressed_pair, move_only_members)
+{
+    compressed_pair<std::unique_ptr<int>, empty1> owner(std::make_unique<int>(42), empty1());
+    auto moved = std::move(owner);
+
+    EXPECT_EQ(owner.first(), nullptr);
+    ASSERT_NE(moved.first(), nullptr);
+    EXPECT_EQ(*moved.first(), 42);
+}
+
+TEST(compressed_pair, structured_bindings)
+{
+    compressed_pair<int, std::string> values(1, "one");
+
+    auto& [number, name] = values;
+    number = 2;
+    name   = "two";
+
+    EXPECT_EQ(values.first(), 2);
+    EXPECT_EQ(values.second(), "two");
+
+    const auto [copy_number, copy_name] = values;
+    EXPECT_EQ(copy_number, 2);
+    EXPECT_EQ(copy_name, "two");
+
+    EXPECT_EQ(get<0>(std::move(values)), 2);
+}
+
+TEST(compressed_pair, comparisons)
+{
+    const compressed_pair<int, int> a(1, 2);
+    const compressed_pair<int, int> b(1, 3);
+    const compressed_pair<int, int> c(1, 2);
+
+    EXPECT_TRUE(a == c);
+    EXPECT_TRUE(a != b);
+    EXPECT_TRUE(a < b);
+    EXPECT_TRUE(a <= c);
+    EXPECT_TRUE(b > a);
+    EXPECT_TRUE(b >= a);
+    EXPECT_TRUE(lexicographical_compare(a, b));
+    EXPECT_FALSE(lexicographical_compare(b, a));
+
+    // the members don't have to be comparable with each other
+    const compressed_pair<std::string, int> d("a", 2);
+    const compressed_pair<std::string, int> e("b", 1);
+    EXPECT_TRUE(d < e);
+    EXPECT_TRUE(d != e);
+}
+
+TEST(compressed_pair, swap)
+{
+    compressed_pair<int, std::string> a(1, "one");
+    compressed_pair<int, std::string> b(2, "two");
+
+    a.swap(b);
+    EXPECT_EQ(a.first(), 2);
+    EXPECT_EQ(a.second(), "two");
+    EXPECT_EQ(b.first(), 1);
+    EXPECT_EQ(b.second(), "one");
+
+    compressed_pair<empty1, int> c(empty1(), 3);
+    compressed_pair<empty1, int> d(empty1(), 4);
+    c.swap(d);
+    EXPECT_EQ(c.second(), 4);
+    EXPECT_EQ(d.second(), 3);
+}
+
+TEST(compressed_pair, hash_skips_empty_members)
+{
+    using int_pair = compressed_pair<int, int>;
+    EXPECT_NE(std::hash<int_pair>{}(int_pair(1, 2)), std::hash<int_pair>{}(int_pair(2, 1)));
+
+    using empty_first  = compressed_pair<empty1, int>;
+    using empty_second = compressed_pair<int, empty2>;
+    EXPECT_EQ(std::hash<empty_first>{}(empty_first(empty1(), 5)),
+              std::hash<empty_second>{}(empty_second(5, empty2())));
+}
+
+TEST(compressed_pair, constexpr_construction)
+{
+    constexpr compressed_pair<int, empty1> values(4, empty1());
+    static_assert(values.first() == 4);
+
+    constexpr compressed_pair<int, int> a(1, 2);
+    constexpr compressed_pair<int, int> b(1, 3);
+    static_assert(a < b);
+}
+
+TEST(compressed_pair, vector_of_trivially_copyable_pairs_is_memmovable)
+{
+    using pair_t = compressed_pair<int, float>;
+    static_assert(std::is_trivially_copyable<pair_t>::value);
+    static_assert(is_trivially_relocatable_v<pair_t>);
+
+    std::vector<pair_t> pairs;
+    for (int i = 0; i != 1000; ++i) pairs.emplace_back(i, static_cast<float>(i) / 2);
+
+    const std::vector<pair_t> copy = pairs;
+    for (int i = 0; i != 1000; ++i)
+    {
+        EXPECT_EQ(copy[i].first(), i);
+        EXPECT_EQ(copy[i].second(), static_cast<float>(i) / 2);
+    }
+}
+
+TEST(compressed_pair, vector_growth_relocates_with_memmove)
+{
+#if defined(__GLIBCXX__) and defined(COMPRESSED_PAIR_LIBSTDCXX_RELOCATION)
+    std::vector<compressed_pair<counted_relocatable, int>> pairs;
+    for (int i = 0; i != 1000; ++i) pairs.emplace_back(counted_relocatable(), i);
+
+    // emplace_back moves each argument once, the reallocations don't move anything
+    EXPECT_EQ(counted_relocatable::moves, 1000);
+    EXPECT_EQ(pairs.back().second(), 999);
+#else
+    GTEST_SKIP() << "relocation of std::vector elements is opted in with "
+                    "COMPRESSED_PAIR_LIBSTDCXX_RELOCATION, for libstdc++ only";
+#endif
+}
+
+TEST(compressed_pair, converts_between_values_and_references)
+{
+    compressed_pair<int, std::string> value(1, "one");
+
+    compressed_pair<int&, std::string&> references = value;
+    references = compressed_pair<int, std::string>(2, "two");
+    EXPECT_EQ(value.first(), 2);
+    EXPECT_EQ(value.second(), "two");
+
+    const compressed_pair<int, std::string> copy = references;
+    EXPECT_EQ(copy, value);
+    EXPECT_TRUE(references == copy);
+    EXPECT_FALSE(references < copy);
+
+    // explicit when a member isn't implicitly convertible
+    using sizes   = compressed_pair<int, std::size_t>;
+    using vectors = compressed_pair<int, std::vector<int>>;
+    static_assert(std::is_constructible<vectors, sizes>::value);
+    static_assert(not std::is_convertible<sizes, vectors>::value);
+    static_assert(std::is_convertible<compressed_pair<int, const char*>, compressed_pair<long, std::string>>::value);
+}
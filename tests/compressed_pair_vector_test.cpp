@@ -0,0 +1,235 @@
+//  ------------------------------------
+//      Copyright (C) 2018 MO ELomari
+//  ------------------------------------
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "compressed_pair_vector.hxx"
+
+
+namespace {
+
+struct empty1 {};
+struct empty2 {};
+
+// points to itself, a relocation with memcpy would leave it pointing to the
+// old array
+struct self_referencing
+{
+    explicit self_referencing(int value) noexcept : value(value) {}
+
+    self_referencing(const self_referencing& other) noexcept : value(other.value) {}
+    self_referencing(self_referencing&& other) noexcept : value(other.value) {}
+
+    auto operator=(const self_referencing& other) noexcept -> self_referencing&
+    {
+        this->value = other.value;
+        return *this;
+    }
+
+    auto valid() const noexcept -> bool { return this->self == this; }
+
+    const self_referencing* self = this;
+    int value;
+};
+
+using vector_t = compressed_pair_vector<int, float>;
+using value_t  = compressed_pair<int, float>;
+
+auto make_vector(int size) -> vector_t
+{
+    vector_t values;
+    for (int i = 0; i != size; ++i) values.emplace_back(size - i, static_cast<float>(i));
+    return values;
+}
+
+// the proxy iterators are C++20 iterators
+static_assert(std::indirectly_readable<vector_t::iterator>);
+static_assert(std::random_access_iterator<vector_t::iterator>);
+static_assert(std::random_access_iterator<vector_t::const_iterator>);
+static_assert(std::indirectly_writable<vector_t::iterator, value_t>);
+static_assert(not std::indirectly_writable<vector_t::const_iterator, value_t>);
+static_assert(std::sortable<vector_t::iterator>);
+static_assert(std::ranges::random_access_range<vector_t>);
+
+static_assert(std::same_as<std::iter_common_reference_t<vector_t::iterator>, compressed_pair<int&, float&>>);
+static_assert(std::same_as<std::iter_rvalue_reference_t<vector_t::iterator>, compressed_pair<int&&, float&&>>);
+
+// an empty member is shared by all the elements
+static_assert(std::sortable<compressed_pair_vector<int, empty1>::iterator, std::ranges::less,
+                            decltype([](const auto& element) { return element.first(); })>);
+
+}  // namespace
+
+
+TEST(compressed_pair_vector, proxy_converts_to_value)
+{
+    auto values = make_vector(3);
+
+    value_t copy = *values.begin();
+    EXPECT_EQ(copy.first(), 3);
+    EXPECT_EQ(copy.second(), 0.0f);
+
+    copy = values[2];
+    EXPECT_EQ(copy.first(), 1);
+}
+
+TEST(compressed_pair_vector, assigns_through_proxy)
+{
+    auto values = make_vector(3);
+
+    values[0] = value_t(10, 1.5f);
+    EXPECT_EQ(values[0].first(), 10);
+    EXPECT_EQ(values.seconds()[0], 1.5f);
+
+    *(values.begin() + 1) = values[0];
+    EXPECT_EQ(values.firsts()[1], 10);
+
+    auto [first, second] = values[2];
+    first  = 7;
+    second = 2.5f;
+    EXPECT_EQ(values[2], value_t(7, 2.5f));
+}
+
+TEST(compressed_pair_vector, sort)
+{
+    auto values = make_vector(1000);
+
+    std::sort(values.begin(), values.end());
+    EXPECT_TRUE(std::is_sorted(values.begin(), values.end()));
+    EXPECT_EQ(values.front(), value_t(1, 999.0f));
+
+    std::ranges::sort(values, std::greater<>());
+    EXPECT_TRUE(std::ranges::is_sorted(values, std::greater<>()));
+    EXPECT_EQ(values.front(), value_t(1000, 0.0f));
+}
+
+TEST(compressed_pair_vector, iter_move_and_iter_swap)
+{
+    compressed_pair_vector<std::unique_ptr<int>, int> values;
+    values.emplace_back(std::make_unique<int>(1), 10);
+    values.emplace_back(std::make_unique<int>(2), 20);
+
+    std::ranges::iter_swap(values.begin(), values.begin() + 1);
+    EXPECT_EQ(*values[0].first(), 2);
+    EXPECT_EQ(values[0].second(), 20);
+
+    compressed_pair<std::unique_ptr<int>, int> moved = std::ranges::iter_move(values.begin());
+    EXPECT_EQ(*moved.first(), 2);
+    EXPECT_EQ(values[0].first(), nullptr);
+
+    *values.begin() = std::move(moved);
+    EXPECT_EQ(*values[0].first(), 2);
+}
+
+TEST(compressed_pair_vector, growth_moves_non_trivially_relocatable_columns)
+{
+    static_assert(not is_trivially_relocatable_v<self_referencing>);
+
+    compressed_pair_vector<self_referencing, std::string> values;
+    for (int i = 0; i != 100; ++i) values.emplace_back(self_referencing(i), std::string(32, char('a' + i % 26)));
+
+    EXPECT_GE(values.capacity(), 100u);
+    for (int i = 0; i != 100; ++i)
+    {
+        EXPECT_TRUE(values.firsts()[i].valid());
+        EXPECT_EQ(values.firsts()[i].value, i);
+        EXPECT_EQ(values.seconds()[i], std::string(32, char('a' + i % 26)));
+    }
+}
+
+TEST(compressed_pair_vector, copy_construction_and_assignment)
+{
+    compressed_pair_vector<std::string, int> values;
+    for (int i = 0; i != 50; ++i) values.emplace_back(std::to_string(i), i);
+
+    const auto copy = values;
+    ASSERT_EQ(copy.size(), 50u);
+    EXPECT_EQ(copy[49].first(), "49");
+    EXPECT_NE(copy.firsts().data(), values.firsts().data());
+
+    compressed_pair_vector<std::string, int> assigned;
+    assigned.emplace_back("old", -1);
+    assigned = copy;
+    ASSERT_EQ(assigned.size(), copy.size());
+    for (std::size_t i = 0; i != copy.size(); ++i) EXPECT_EQ(assigned[i], copy[i]);
+
+    assigned = assigned;
+    EXPECT_EQ(assigned.size(), 50u);
+}
+
+TEST(compressed_pair_vector, pop_back_and_clear_with_empty_columns)
+{
+    compressed_pair_vector<int, float> none;
+    none.clear();
+    EXPECT_TRUE(none.empty());
+
+    compressed_pair_vector<std::string, empty1> one_empty;
+    one_empty.clear();
+    one_empty.emplace_back("a", empty1());
+    one_empty.emplace_back("b", empty1());
+
+    one_empty.pop_back();
+    ASSERT_EQ(one_empty.size(), 1u);
+    EXPECT_EQ(one_empty.back().first(), "a");
+
+    one_empty.clear();
+    EXPECT_TRUE(one_empty.empty());
+    EXPECT_GE(one_empty.capacity(), 2u);
+
+    compressed_pair_vector<empty1, empty2> both_empty;
+    both_empty.emplace_back(empty1(), empty2());
+    both_empty.pop_back();
+    EXPECT_TRUE(both_empty.empty());
+    both_empty.clear();
+}
+
+TEST(compressed_pair_vector, ranges_algorithms_move_and_swap_the_elements)
+{
+    // the elements are moved out and back through the proxies
+    compressed_pair_vector<std::string, int> values;
+    for (int i = 0; i != 200; ++i) values.emplace_back(std::string(20, char('a' + i % 26)) + std::to_string(i), (i * 37) % 200);
+
+    std::ranges::sort(values, std::less<>(), [](const auto& element) { return element.second(); });
+
+    for (int i = 0; i != 200; ++i)
+    {
+        const int original = (i * 173) % 200;  // 173 is the inverse of 37 modulo 200
+        EXPECT_EQ(values[i].second(), i);
+        EXPECT_EQ(values[i].first(), std::string(20, char('a' + original % 26)) + std::to_string(original));
+    }
+
+    // move-only elements are swapped through iter_swap
+    compressed_pair_vector<std::unique_ptr<int>, int> owners;
+    for (int i = 0; i != 5; ++i) owners.emplace_back(std::make_unique<int>(i), i);
+
+    std::ranges::reverse(owners);
+    for (int i = 0; i != 5; ++i)
+    {
+        ASSERT_NE(owners[i].first(), nullptr);
+        EXPECT_EQ(*owners[i].first(), 4 - i);
+        EXPECT_EQ(owners[i].second(), 4 - i);
+    }
+}
+
+TEST(compressed_pair_vector, reserve_beyond_max_size_throws)
+{
+    compressed_pair_vector<std::uint64_t, int> values;
+    EXPECT_EQ(values.max_size(), std::size_t(std::numeric_limits<std::ptrdiff_t>::max()) / sizeof(std::uint64_t));
+
+    EXPECT_THROW(values.reserve(values.max_size() + 1), std::length_error);
+    EXPECT_THROW(values.reserve(std::numeric_limits<std::size_t>::max() / 4 + 1), std::length_error);
+    EXPECT_EQ(values.capacity(), 0u);
+}
@@ -0,0 +1,58 @@
+//  ------------------------------------
+//      Copyright (C) 2018 MO ELomari
+//  ------------------------------------
+
+#include <string>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "compressed_tuple.hxx"
+
+
+namespace {
+
+struct empty1 {};
+
+}  // namespace
+
+
+TEST(compressed_tuple, get_uses_declaration_order)
+{
+    compressed_tuple<char, double, int> values('a', 2.5, 3);
+    EXPECT_EQ(values.get<0>(), 'a');
+    EXPECT_EQ(values.get<1>(), 2.5);
+    EXPECT_EQ(values.get<2>(), 3);
+}
+
+TEST(compressed_tuple, packed_layout_keeps_declaration_order)
+{
+    packed_compressed_tuple<char, double, int> values('a', 2.5, 3);
+
+    auto& [c, d, i] = values;
+    EXPECT_EQ(c, 'a');
+    EXPECT_EQ(d, 2.5);
+    EXPECT_EQ(i, 3);
+
+    i = 4;
+    EXPECT_EQ(get<2>(values), 4);
+}
+
+TEST(compressed_tuple, empty_members_and_repeated_types)
+{
+    compressed_tuple<empty1, std::string, empty1, std::string> values(empty1(), "a", empty1(), "b");
+    EXPECT_EQ(values.get<1>(), "a");
+    EXPECT_EQ(values.get<3>(), "b");
+}
+
+TEST(compressed_tuple, swap_and_compare)
+{
+    compressed_tuple<int, std::string> a(1, "one");
+    compressed_tuple<int, std::string> b(2, "two");
+    const compressed_tuple<int, std::string> one(1, "one");
+
+    a.swap(b);
+    EXPECT_EQ(b, one);
+    EXPECT_NE(a, one);
+    EXPECT_EQ(std::move(a).get<1>(), "two");
+}
@@ -0,0 +1,152 @@
+//  ------------------------------------
+//      Copyright (C) 2018 MO ELomari
+//  ------------------------------------
+
+#include <cstddef>
+#include <string>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "compressed_unique_ptr.hxx"
+#include "memory_arena.hxx"
+
+
+namespace {
+
+struct base
+{
+    explicit base(int& destroyed) noexcept : destroyed(destroyed) {}
+    virtual ~base() { ++this->destroyed; }
+
+    int& destroyed;
+};
+
+struct derived : public base
+{
+    using base::base;
+};
+
+// counts the objects it deletes
+struct counting_delete
+{
+    void operator()(base* ptr) noexcept
+    {
+        ++this->calls;
+        delete ptr;
+    }
+
+    int calls = 0;
+};
+
+}  // namespace
+
+
+TEST(compressed_unique_ptr, release_and_reset)
+{
+    int destroyed = 0;
+
+    compressed_unique_ptr<base> owner(new base(destroyed));
+    ASSERT_TRUE(owner);
+
+    base* released = owner.release();
+    EXPECT_FALSE(owner);
+    EXPECT_EQ(owner, nullptr);
+    EXPECT_EQ(destroyed, 0);
+
+    owner.reset(released);
+    EXPECT_EQ(owner.get(), released);
+
+    owner.reset(new base(destroyed));
+    EXPECT_EQ(destroyed, 1);
+
+    owner.reset();
+    EXPECT_EQ(destroyed, 2);
+    EXPECT_EQ(owner.get(), nullptr);
+}
+
+TEST(compressed_unique_ptr, move_transfers_ownership)
+{
+    int destroyed = 0;
+
+    compressed_unique_ptr<base, counting_delete> source(new base(destroyed), counting_delete{});
+    base* object = source.get();
+
+    compressed_unique_ptr<base, counting_delete> target(std::move(source));
+    EXPECT_EQ(source.get(), nullptr);
+    EXPECT_EQ(target.get(), object);
+
+    compressed_unique_ptr<base, counting_delete> assigned(new base(destroyed), counting_delete{});
+    assigned = std::move(target);
+    EXPECT_EQ(destroyed, 1);
+    EXPECT_EQ(assigned.get(), object);
+    EXPECT_EQ(target.get(), nullptr);
+
+    // the deleter is moved along with the object
+    assigned = nullptr;
+    EXPECT_EQ(destroyed, 2);
+    EXPECT_EQ(assigned.get_deleter().calls, 1);
+}
+
+TEST(compressed_unique_ptr, converts_derived_to_base)
+{
+    int destroyed = 0;
+
+    compressed_unique_ptr<derived> source(new derived(destroyed));
+    derived* object = source.get();
+
+    compressed_unique_ptr<base> converted(std::move(source));
+    EXPECT_EQ(source.get(), nullptr);
+    EXPECT_EQ(converted.get(), object);
+
+    compressed_unique_ptr<base> assigned;
+    assigned = compressed_unique_ptr<derived>(new derived(destroyed));
+    assigned = std::move(converted);
+    EXPECT_EQ(destroyed, 1);
+    EXPECT_EQ(assigned.get(), object);
+
+    assigned.reset();
+    EXPECT_EQ(destroyed, 2);
+}
+
+TEST(compressed_unique_ptr, reference_deleter)
+{
+    int destroyed = 0;
+    counting_delete deleter;
+
+    {
+        compressed_unique_ptr<base, counting_delete&> owner(new base(destroyed), deleter);
+        EXPECT_EQ(&owner.get_deleter(), &deleter);
+    }
+
+    EXPECT_EQ(destroyed, 1);
+    EXPECT_EQ(deleter.calls, 1);
+}
+
+TEST(compressed_unique_ptr, allocate_in_a_pool)
+{
+    fixed_pool pool(sizeof(std::string));
+
+    auto first = allocate_compressed_unique<std::string>(pool_allocator<std::string>(pool), "first");
+    EXPECT_EQ(*first, "first");
+    EXPECT_EQ(first.get_deleter().get_allocator().resource(), &pool);
+
+    // the block of the destroyed string is reused by the next one
+    std::string* block = first.get();
+    first.reset();
+
+    auto second = allocate_compressed_unique<std::string>(pool_allocator<std::string>(pool), 3, 'x');
+    EXPECT_EQ(second.get(), block);
+    EXPECT_EQ(*second, "xxx");
+}
+
+TEST(compressed_unique_ptr, allocate_in_an_arena)
+{
+    alignas(std::max_align_t) std::byte buffer[256];
+    monotonic_arena arena(buffer, sizeof(buffer));
+
+    auto value = allocate_compressed_unique<int>(arena_allocator<int>(arena), 42);
+    EXPECT_EQ(*value, 42);
+    EXPECT_GE(reinterpret_cast<std::byte*>(value.get()), buffer);
+    EXPECT_LT(reinterpret_cast<std::byte*>(value.get()), buffer + sizeof(buffer));
+}
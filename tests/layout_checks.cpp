@@ -0,0 +1,254 @@
+//  ------------------------------------
+//      Copyright (C) 2018 MO ELomari
+//  ------------------------------------
+
+// Compile-time layout checks of all the headers. they used to live at the end
+// of each header, where every translation unit including it paid for them;
+// they are only compiled here, as part of the test target.
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "atomic_compressed_pair.hxx"
+#include "compressed_buffer.hxx"
+#include "compressed_flat_map.hxx"
+#include "compressed_pair.hxx"
+#include "compressed_pair_table.hxx"
+#include "compressed_pair_vector.hxx"
+#include "compressed_tuple.hxx"
+#include "compressed_unique_ptr.hxx"
+#include "memory_arena.hxx"
+#include "tagged_pointer_pair.hxx"
+
+
+namespace detail::checks {
+
+struct empty1 {};
+struct empty2 {};
+
+struct non_trivial
+{
+    non_trivial(const non_trivial&) {}
+};
+
+struct aligned_node { aligned_node* next; };
+
+}  // namespace detail::checks
+
+
+
+// compressed_pair.hxx
+namespace detail::checks {
+
+// the special members follow the triviality of the members in all four
+// compressed_pair_impl specializations
+static_assert(std::is_trivially_copyable<compressed_pair<int, float>>::value);
+static_assert(std::is_trivially_copyable<compressed_pair<empty1, float>>::value);
+static_assert(std::is_trivially_copyable<compressed_pair<int, empty2>>::value);
+static_assert(std::is_trivially_copyable<compressed_pair<empty1, empty2>>::value);
+
+static_assert(std::is_trivially_copy_constructible<compressed_pair<int, float>>::value);
+static_assert(std::is_trivially_move_constructible<compressed_pair<int, float>>::value);
+static_assert(std::is_trivially_copy_assignable<compressed_pair<int, float>>::value);
+static_assert(std::is_trivially_move_assignable<compressed_pair<int, float>>::value);
+
+static_assert(not std::is_trivially_copyable<compressed_pair<non_trivial, int>>::value);
+static_assert(not std::is_trivially_copyable<compressed_pair<int, non_trivial>>::value);
+
+// the same empty type twice can't be inherited twice, the second one is a member
+static_assert(std::is_trivially_copyable<compressed_pair<empty1, empty1>>::value);
+static_assert(sizeof(compressed_pair<empty1, int>) == sizeof(int));
+
+// layout audit of the four compressed_pair_impl specializations: never larger
+// than std::pair, and the same layout as [[no_unique_address]] members
+template <typename T1, typename T2>
+struct no_unique_address_pair
+{
+    [[no_unique_address]] T1 first;
+    [[no_unique_address]] T2 second;
+};
+
+template <typename T1, typename T2>
+inline constexpr bool audit_layout =
+    sizeof(compressed_pair<T1, T2>) <= sizeof(std::pair<T1, T2>) and
+    alignof(compressed_pair<T1, T2>) == alignof(std::pair<T1, T2>) and
+    sizeof(compressed_pair<T1, T2>) == sizeof(no_unique_address_pair<T1, T2>) and
+    alignof(compressed_pair<T1, T2>) == alignof(no_unique_address_pair<T1, T2>);
+
+static_assert(audit_layout<int, float>);
+static_assert(audit_layout<char, double>);
+static_assert(audit_layout<empty1, float>);
+static_assert(audit_layout<int, empty2>);
+static_assert(audit_layout<empty1, empty2>);
+static_assert(audit_layout<empty1, empty1>);
+
+static_assert(sizeof(compressed_pair<empty1, double>) < sizeof(std::pair<empty1, double>));
+static_assert(sizeof(compressed_pair<empty1, empty2>) == 1);
+
+// compressed_pair never packs a pointer, its layout doesn't depend on the
+// alignment ( or the completeness ) of the pointee
+static_assert(audit_layout<aligned_node*, bool>);
+
+static_assert(is_trivially_relocatable_v<compressed_pair<int*, long>>);
+static_assert(is_trivially_relocatable_v<compressed_pair<empty1, empty2>>);
+static_assert(not is_trivially_relocatable_v<compressed_pair<non_trivial, int>>);
+
+}  // namespace detail::checks
+
+
+
+// compressed_tuple.hxx
+namespace detail::checks {
+
+// mixed char/double/int record: 24 bytes in declaration order, 16 packed
+static_assert(sizeof(compressed_tuple<char, double, int>) == 3 * sizeof(double));
+static_assert(sizeof(packed_compressed_tuple<char, double, int>) == 2 * sizeof(double));
+
+// stateless policies don't take any space
+static_assert(sizeof(compressed_tuple<empty1, int, empty2>) == sizeof(int));
+
+static_assert(std::is_trivially_copyable<packed_compressed_tuple<char, double, empty1>>::value);
+
+}  // namespace detail::checks
+
+
+
+// compressed_pair_vector.hxx
+namespace detail::checks {
+
+// an empty member type doesn't get an array
+static_assert(sizeof(compressed_pair_vector<int, empty1>) == 3 * sizeof(void*));
+static_assert(sizeof(compressed_pair_vector<int, float>) == 4 * sizeof(void*));
+
+}  // namespace detail::checks
+
+
+
+// compressed_flat_map.hxx
+namespace detail::checks {
+
+// stateless hasher and key_equal don't take any space
+static_assert(sizeof(compressed_flat_map<int, int>) == 3 * sizeof(void*));
+
+// an empty mapped type makes a set, its slots only hold the key
+static_assert(sizeof(compressed_pair<int, empty1>) == sizeof(int));
+
+}  // namespace detail::checks
+
+
+
+// atomic_compressed_pair.hxx
+namespace detail::checks {
+
+static_assert(atomic_compressed_pair<int, float>::is_always_lock_free);
+
+#if defined(ATOMIC_COMPRESSED_PAIR_DWCAS)
+static_assert(atomic_compressed_pair<aligned_node*, bool>::is_always_lock_free);
+static_assert(atomic_compressed_pair<aligned_node*, std::uint64_t>::is_always_lock_free);
+#endif
+
+}  // namespace detail::checks
+
+
+
+// compressed_unique_ptr.hxx
+namespace detail::checks {
+
+struct stateless_deleter
+{
+    void operator()(int* ptr) const noexcept { delete ptr; }
+};
+
+// a stateless deleter or allocator doesn't take any space
+static_assert(sizeof(compressed_unique_ptr<int>) == sizeof(int*));
+static_assert(sizeof(compressed_unique_ptr<int, stateless_deleter>) == sizeof(int*));
+static_assert(sizeof(compressed_unique_ptr<int, allocator_delete<std::allocator<int>>>) == sizeof(int*));
+static_assert(sizeof(compressed_unique_ptr<int, void (*)(int*)>) == 2 * sizeof(int*));
+
+static_assert(is_trivially_relocatable_v<compressed_unique_ptr<int>>);
+static_assert(is_trivially_relocatable_v<compressed_unique_ptr<int, stateless_deleter&>>);
+
+// a fancy pointer whose copies depend on their address isn't relocated with memcpy
+struct self_relative_pointer
+{
+    self_relative_pointer() = default;
+    self_relative_pointer(std::nullptr_t) noexcept {}
+    self_relative_pointer(const self_relative_pointer&) noexcept {}
+
+    friend auto operator==(const self_relative_pointer&, const self_relative_pointer&) -> bool = default;
+
+    std::ptrdiff_t offset = 0;
+};
+
+struct self_relative_deleter
+{
+    using pointer = self_relative_pointer;
+    void operator()(self_relative_pointer) const noexcept {}
+};
+
+static_assert(not is_trivially_relocatable_v<compressed_unique_ptr<int, self_relative_deleter>>);
+
+}  // namespace detail::checks
+
+
+
+// compressed_buffer.hxx and memory_arena.hxx
+namespace detail::checks {
+
+// a stateless allocator doesn't take any space
+static_assert(sizeof(compressed_buffer<int>) == 3 * sizeof(void*));
+static_assert(sizeof(compressed_buffer<compressed_pair<int, empty1>>) == 3 * sizeof(void*));
+
+// a stateful allocator is a single pointer
+static_assert(sizeof(arena_allocator<int>) == sizeof(void*));
+static_assert(sizeof(compressed_buffer<int, arena_allocator<int>>) == 4 * sizeof(void*));
+static_assert(std::is_trivially_copyable<pool_allocator<double>>::value);
+
+}  // namespace detail::checks
+
+
+
+// tagged_pointer_pair.hxx
+namespace detail::checks {
+
+// a node holding a pair of a pointer to itself, the pair is a single word
+// although the node is incomplete where the pair is declared
+struct tree_node
+{
+    tagged_pointer_pair<tree_node, bool> parent;
+    tree_node* children[2];
+};
+
+static_assert(sizeof(tagged_pointer_pair<tree_node, bool>) == sizeof(void*));
+static_assert(sizeof(tree_node) == 3 * sizeof(void*));
+static_assert(std::is_trivially_copyable<tagged_pointer_pair<tree_node, bool>>::value);
+
+// the elements of a non-const pair are the proxy references, a structured
+// binding assigns the pair
+static_assert(std::is_same<std::tuple_element_t<1, tagged_pointer_pair<tree_node, bool>>,
+                           tagged_pointer_pair<tree_node, bool>::second_reference>::value);
+static_assert(std::is_same<std::tuple_element_t<1, const tagged_pointer_pair<tree_node, bool>>, bool>::value);
+
+constexpr tagged_pointer_pair<tree_node, bool> root(nullptr, true);
+static_assert(root.first() == nullptr and root.second());
+
+}  // namespace detail::checks
+
+
+
+// compressed_pair_table.hxx
+namespace detail::checks {
+
+static_assert(std::is_trivially_copyable<compressed_pair_table_header>::value);
+static_assert(sizeof(compressed_pair_table_header) == 112);
+
+static_assert(table_data_offset<compressed_pair<int, double>> == 128);
+
+// an empty member doesn't take any byte on disk
+static_assert(mappable_pair<int, empty1>);
+static_assert(not mappable_pair<aligned_node*, bool>);
+
+}  // namespace detail::checks
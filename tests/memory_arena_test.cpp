@@ -0,0 +1,151 @@
+//  ------------------------------------
+//      Copyright (C) 2018 MO ELomari
+//  ------------------------------------
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "memory_arena.hxx"
+
+
+namespace {
+
+auto is_aligned(const void* ptr, std::size_t alignment) noexcept -> bool
+{
+    return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+}
+
+}  // namespace
+
+
+TEST(monotonic_arena, grows_past_its_buffer)
+{
+    alignas(std::max_align_t) std::byte buffer[64];
+    monotonic_arena arena(buffer, sizeof(buffer));
+
+    auto* first  = static_cast<std::byte*>(arena.allocate(32));
+    auto* second = static_cast<std::byte*>(arena.allocate(32));
+    EXPECT_EQ(first, buffer);
+    EXPECT_EQ(second, buffer + 32);
+
+    // the buffer is full, the next requests are served from chunks
+    auto* chunked = static_cast<std::byte*>(arena.allocate(16));
+    EXPECT_TRUE(chunked < buffer or chunked >= buffer + sizeof(buffer));
+
+    // a request larger than the next chunk gets its own chunk
+    auto* large = static_cast<std::byte*>(arena.allocate(1 << 20));
+    large[(1 << 20) - 1] = std::byte{1};
+}
+
+TEST(monotonic_arena, over_aligned_requests)
+{
+    alignas(std::max_align_t) std::byte buffer[1024];
+    monotonic_arena arena(buffer, sizeof(buffer));
+
+    arena.allocate(1, 1);
+    EXPECT_TRUE(is_aligned(arena.allocate(8, 256), 256));
+    EXPECT_TRUE(is_aligned(arena.allocate(8, 64), 64));
+
+    // also in a chunk
+    arena.allocate(sizeof(buffer));
+    EXPECT_TRUE(is_aligned(arena.allocate(8, 4096), 4096));
+}
+
+TEST(monotonic_arena, release_serves_the_buffer_again)
+{
+    alignas(std::max_align_t) std::byte buffer[128];
+    monotonic_arena arena(buffer, sizeof(buffer));
+
+    for (int i = 0; i != 100; ++i) arena.allocate(64);
+
+    arena.release();
+    EXPECT_EQ(arena.allocate(16), buffer);
+
+    // an arena without buffer allocates a new chunk
+    monotonic_arena chunked(256);
+    void* first = chunked.allocate(16);
+    chunked.release();
+    EXPECT_NE(chunked.allocate(16), nullptr);
+    EXPECT_NE(first, nullptr);
+}
+
+TEST(fixed_pool, reuses_freed_blocks)
+{
+    fixed_pool pool(24, alignof(std::max_align_t), 4);
+    EXPECT_EQ(pool.block_size() % alignof(std::max_align_t), 0u);
+
+    void* first  = pool.allocate(24);
+    void* second = pool.allocate(16);
+    EXPECT_NE(first, second);
+
+    // the last freed block is the first reused
+    pool.deallocate(first, 24);
+    pool.deallocate(second, 16);
+    EXPECT_EQ(pool.allocate(24), second);
+    EXPECT_EQ(pool.allocate(24), first);
+
+    // past the first chunk of 4 blocks
+    std::vector<void*> blocks;
+    for (int i = 0; i != 10; ++i) blocks.push_back(pool.allocate(24));
+    for (auto* block : blocks) EXPECT_TRUE(is_aligned(block, alignof(std::max_align_t)));
+}
+
+TEST(fixed_pool, forwards_oversized_and_over_aligned_requests)
+{
+    fixed_pool pool(32, 16);
+
+    void* oversized = pool.allocate(pool.block_size() + 1);
+    static_cast<std::byte*>(oversized)[pool.block_size()] = std::byte{1};
+
+    void* over_aligned = pool.allocate(8, 256);
+    EXPECT_TRUE(is_aligned(over_aligned, 256));
+
+    // the forwarded blocks aren't added to the free list
+    pool.deallocate(oversized, pool.block_size() + 1);
+    pool.deallocate(over_aligned, 8, 256);
+
+    void* block = pool.allocate(32);
+    EXPECT_NE(block, oversized);
+    EXPECT_NE(block, over_aligned);
+}
+
+TEST(resource_allocator, standard_containers)
+{
+    fixed_pool pool(sizeof(int));
+
+    using allocator_t = resource_allocator<int, fixed_pool>;
+
+    std::vector<int, allocator_t> values(pool);
+    for (int i = 0; i != 1000; ++i) values.push_back(i);
+    EXPECT_EQ(values[999], 999);
+
+    const resource_allocator<long, fixed_pool> rebound(values.get_allocator());
+    EXPECT_EQ(rebound.resource(), &pool);
+    EXPECT_TRUE(rebound == values.get_allocator());
+
+    fixed_pool other(sizeof(int));
+    EXPECT_FALSE(allocator_t(other) == values.get_allocator());
+}
+
+TEST(memory_resource_adaptor, pmr_containers)
+{
+    alignas(std::max_align_t) std::byte buffer[256];
+    monotonic_arena arena(buffer, sizeof(buffer));
+    memory_resource_adaptor<monotonic_arena> resource(arena);
+
+    std::pmr::vector<int> values(&resource);
+    for (int i = 0; i != 1000; ++i) values.push_back(i);
+    EXPECT_EQ(values[999], 999);
+
+    memory_resource_adaptor<monotonic_arena> same(arena);
+    monotonic_arena other_arena;
+    memory_resource_adaptor<monotonic_arena> other(other_arena);
+
+    EXPECT_TRUE(resource.is_equal(same));
+    EXPECT_FALSE(resource.is_equal(other));
+    EXPECT_FALSE(resource.is_equal(*std::pmr::new_delete_resource()));
+}
@@ -0,0 +1,145 @@
+//  ------------------------------------
+//      Copyright (C) 2018 MO ELomari
+//  ------------------------------------
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "tagged_pointer_pair.hxx"
+
+
+namespace {
+
+enum class color : unsigned char { red, black, blue };
+
+}  // namespace
+
+template <>
+struct packed_value_traits<color>
+{
+    static constexpr std::size_t bits = 2;
+};
+
+namespace {
+
+// a node holding a pair of a pointer to itself
+struct node
+{
+    tagged_pointer_pair<node, color> parent;
+    int value = 0;
+};
+
+using int_flag = tagged_pointer_pair<int, bool>;
+
+// true if a pair holding value is a constant expression
+template <color Value>
+concept stores_in_range = requires {
+    typename std::integral_constant<bool, tagged_pointer_pair<node, color>(nullptr, Value).second() == Value>;
+};
+
+}  // namespace
+
+
+TEST(tagged_pointer_pair, stores_the_pointer_and_the_value)
+{
+    node root;
+    node child{tagged_pointer_pair<node, color>(&root, color::blue), 1};
+
+    EXPECT_EQ(child.parent.first(), &root);
+    EXPECT_EQ(child.parent.second(), color::blue);
+
+    child.parent.second() = color::red;
+    EXPECT_EQ(child.parent.first(), &root);
+    EXPECT_EQ(child.parent.second(), color::red);
+
+    child.parent.first()->value = 7;
+    EXPECT_EQ(root.value, 7);
+
+    child.parent.first() = nullptr;
+    EXPECT_EQ(child.parent.first(), nullptr);
+    EXPECT_EQ(child.parent.second(), color::red);
+}
+
+TEST(tagged_pointer_pair, structured_bindings_assign_the_pair)
+{
+    int values[2] = {1, 2};
+    int_flag pair(values, false);
+
+    auto& [pointer, flag] = pair;
+    flag    = true;
+    pointer = values + 1;
+
+    EXPECT_TRUE(pair.second());
+    EXPECT_EQ(pair.first(), values + 1);
+    EXPECT_EQ(*pointer, 2);
+
+    const auto& [const_pointer, const_flag] = std::as_const(pair);
+    EXPECT_EQ(const_pointer, values + 1);
+    EXPECT_TRUE(const_flag);
+
+    const auto [copy_pointer, copy_flag] = int_flag(values, true);
+    EXPECT_EQ(copy_pointer, values);
+    EXPECT_TRUE(copy_flag);
+}
+
+TEST(tagged_pointer_pair, get_of_an_rvalue_returns_values)
+{
+    int value = 0;
+
+    // a proxy would refer to the destroyed temporary
+    static_assert(std::is_same<decltype(get<0>(int_flag())), int*>::value);
+    static_assert(std::is_same<decltype(get<1>(int_flag())), bool>::value);
+    static_assert(std::is_same<decltype(get<1>(std::declval<int_flag&>())), int_flag::second_reference>::value);
+
+    auto pointer = get<0>(int_flag(&value, true));
+    auto flag    = get<1>(int_flag(&value, true));
+    EXPECT_EQ(pointer, &value);
+    EXPECT_TRUE(flag);
+}
+
+TEST(tagged_pointer_pair, values_out_of_range)
+{
+    static_assert(stores_in_range<color::blue>);
+    static_assert(not stores_in_range<static_cast<color>(4)>);
+    static_assert(not stores_in_range<static_cast<color>(-1)>);
+
+#if defined(NDEBUG)
+    GTEST_SKIP() << "the range of the values is asserted";
+#else
+    node root;
+    EXPECT_DEATH((tagged_pointer_pair<node, color>(&root, static_cast<color>(4))), "tagged_pointer_pair");
+
+    tagged_pointer_pair<node, color> pair(&root, color::red);
+    EXPECT_DEATH(pair.second() = static_cast<color>(-1), "tagged_pointer_pair");
+#endif
+}
+
+TEST(tagged_pointer_pair, swap_and_compare)
+{
+    int a = 0;
+    int b = 0;
+
+    int_flag lhs(&a, true);
+    int_flag rhs(&b, false);
+
+    swap(lhs, rhs);
+    EXPECT_EQ(lhs, int_flag(&b, false));
+    EXPECT_EQ(rhs, int_flag(&a, true));
+
+    swap(lhs.second(), rhs.second());
+    EXPECT_TRUE(lhs.second());
+    EXPECT_EQ(lhs.first(), &b);
+    EXPECT_NE(lhs, rhs);
+}
+
+TEST(tagged_pointer_pair, constexpr_construction)
+{
+    constexpr tagged_pointer_pair<node, color> empty;
+    static_assert(empty.first() == nullptr and empty.second() == color::red);
+
+    constexpr tagged_pointer_pair<node, color> black(nullptr, color::black);
+    static_assert(get<1>(black) == color::black);
+}